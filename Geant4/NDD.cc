@@ -40,8 +40,9 @@ int main(int argc,char** argv)
   //
   // Detector construction
   G4String parallelWorldName = "ReadoutWorld";
-  G4VUserDetectorConstruction* detector = new NDDDetectorConstruction;
-  detector->RegisterParallelWorld(new NDDPixelReadOut(parallelWorldName));
+  NDDDetectorConstruction* detector = new NDDDetectorConstruction;
+  detector->RegisterParallelWorld(
+      new NDDPixelReadOut(parallelWorldName, detector));
   runManager->SetUserInitialization(detector);
   // Physics list
   G4VModularPhysicsList* physicsList = new NDDPhysicsList;
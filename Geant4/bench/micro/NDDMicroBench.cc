@@ -0,0 +1,253 @@
+// Microbenchmark for the per-step and per-event user code.
+//
+// Drives the real NDDSiPixelSD, NDDSteppingAction and NDDEventAction with a
+// synthetic stream of steps in a minimal seven pixel geometry, without a run
+// manager or any transport. Reports ns per step for ProcessHits and
+// UserSteppingAction, and ns per event for Begin/EndOfEventAction (which
+// includes ClassifyEvent and all Fill*Tuple calls). Fails if the SD does
+// not make one hit per step with energy deposit, with the step's energy.
+//
+// usage: NDDMicroBench [events] [stepsPerEvent]
+
+#include "NDDSiPixelSD.hh"
+#include "NDDSiPixelHit.hh"
+#include "NDDEventAction.hh"
+#include "NDDSteppingAction.hh"
+#include "NDDRunAction.hh"
+
+#include "G4Box.hh"
+#include "G4Polyhedra.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PVPlacement.hh"
+#include "G4NistManager.hh"
+#include "G4Navigator.hh"
+#include "G4TouchableHistory.hh"
+#include "G4TouchableHandle.hh"
+#include "G4SDManager.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4Event.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Electron.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4RandomDirection.hh"
+#include "Randomize.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const G4double pixelSize = 7 * mm;
+const G4double siThickness = 2 * mm;
+
+G4VPhysicalVolume* BuildGeometry() {
+  G4NistManager* nist = G4NistManager::Instance();
+  G4Material* vacuum = nist->FindOrBuildMaterial("G4_Galactic");
+  G4Material* silicon = nist->FindOrBuildMaterial("G4_Si");
+
+  G4Box* solidWorld = new G4Box("World", 5 * cm, 5 * cm, 5 * cm);
+  G4LogicalVolume* logicalWorld =
+      new G4LogicalVolume(solidWorld, vacuum, "World");
+  G4VPhysicalVolume* physicalWorld =
+      new G4PVPlacement(0, G4ThreeVector(), logicalWorld, "World", 0, false, 0);
+
+  G4double zPlanes[2] = {-siThickness / 2., siThickness / 2.};
+  G4double rInner[2] = {0., 0.};
+  G4double rOuter[2] = {pixelSize / 2., pixelSize / 2.};
+  G4Polyhedra* solidPixel = new G4Polyhedra("solidPixel", 0, 360. * deg, 6, 2,
+                                            zPlanes, rInner, rOuter);
+  G4LogicalVolume* logicalPixel =
+      new G4LogicalVolume(solidPixel, silicon, "logicalPixel");
+
+  // central pixel plus its first ring
+  new G4PVPlacement(0, G4ThreeVector(), logicalPixel, "SiPixel", logicalWorld,
+                    false, 1);
+  for (G4int i = 0; i < 6; i++) {
+    G4double phi = (30. + 60. * i) * deg;
+    new G4PVPlacement(
+        0, G4ThreeVector(pixelSize * std::cos(phi), pixelSize * std::sin(phi), 0),
+        logicalPixel, "SiPixel", logicalWorld, false, i + 2);
+  }
+  return physicalWorld;
+}
+
+struct SyntheticStep {
+  G4Step* step;
+  G4Track* track;
+};
+
+std::vector<SyntheticStep> BuildSteps(G4VPhysicalVolume* world, G4int n) {
+  G4Navigator navigator;
+  navigator.SetWorldVolume(world);
+
+  std::vector<SyntheticStep> steps;
+  steps.reserve(n);
+  for (G4int i = 0; i < n; i++) {
+    // inside the inscribed circle of one of the pixels, as the SD only ever
+    // sees steps in the readout pixels
+    G4int pixel = (G4int)(7 * G4UniformRand());
+    G4ThreeVector pos;
+    if (pixel > 0) {
+      G4double phi = (30. + 60. * (pixel - 1)) * deg;
+      pos.set(pixelSize * std::cos(phi), pixelSize * std::sin(phi), 0.);
+    }
+    G4double r = 0.45 * pixelSize * std::sqrt(G4UniformRand());
+    G4double phi = twopi * G4UniformRand();
+    pos += G4ThreeVector(r * std::cos(phi), r * std::sin(phi),
+                         (G4UniformRand() - 0.5) * siThickness);
+    G4ThreeVector dir = G4RandomDirection();
+    G4double ekin = 300 * keV * G4UniformRand();
+
+    navigator.LocateGlobalPointAndSetup(pos);
+    G4TouchableHandle touchable(navigator.CreateTouchableHistory());
+
+    G4DynamicParticle* particle =
+        new G4DynamicParticle(G4Electron::Definition(), dir, ekin);
+    G4Track* track = new G4Track(particle, i * 0.01 * ns, pos);
+    track->SetTrackID(1 + i % 5);
+    track->SetTouchableHandle(touchable);
+
+    G4Step* step = new G4Step();
+    step->SetTrack(track);
+    track->SetStep(step);
+    step->SetTotalEnergyDeposit(10 * keV * G4UniformRand());
+
+    G4StepPoint* points[2] = {step->GetPreStepPoint(), step->GetPostStepPoint()};
+    for (G4StepPoint* point : points) {
+      point->SetPosition(pos);
+      point->SetGlobalTime(track->GetGlobalTime());
+      point->SetMomentumDirection(dir);
+      point->SetKineticEnergy(ekin);
+      point->SetMass(particle->GetMass());
+      point->SetTouchableHandle(touchable);
+    }
+
+    SyntheticStep s = {step, track};
+    steps.push_back(s);
+  }
+  return steps;
+}
+
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv) {
+  G4int nEvents = argc > 1 ? std::atoi(argv[1]) : 20000;
+  G4int stepsPerEvent = argc > 2 ? std::atoi(argv[2]) : 50;
+
+  G4Random::setTheEngine(new CLHEP::RanecuEngine);
+
+  G4VPhysicalVolume* world = BuildGeometry();
+  std::vector<SyntheticStep> steps = BuildSteps(world, 4096);
+
+  NDDSiPixelSD* pixelSD =
+      new NDDSiPixelSD("/NND/SiPixel", "SiPixelHitCollection");
+  G4SDManager* sdManager = G4SDManager::GetSDMpointer();
+  sdManager->AddNewDetector(pixelSD);
+  G4int hcID = sdManager->GetCollectionID("SiPixelHitCollection");
+
+  NDDRunAction runAction;
+  runAction.SetFilename("microbench");
+  runAction.BeginOfRunAction(nullptr);
+
+  NDDEventAction eventAction(&runAction);
+  NDDSteppingAction steppingAction(&eventAction);
+
+  Clock::duration tSD(0), tStepping(0), tEvent(0);
+  size_t next = 0;
+  G4long nBadEvents = 0;
+
+  for (G4int iEvent = 0; iEvent < nEvents; iEvent++) {
+    G4Event* evt = new G4Event(iEvent);
+    evt->SetHCofThisEvent(sdManager->PrepareNewEvent());
+
+    Clock::time_point t0 = Clock::now();
+    eventAction.BeginOfEventAction(evt);
+    Clock::time_point t1 = Clock::now();
+
+    size_t first = next;
+    for (G4int i = 0; i < stepsPerEvent; i++) {
+      pixelSD->ProcessHits(steps[next].step, nullptr);
+      next = (next + 1) % steps.size();
+    }
+    Clock::time_point t2 = Clock::now();
+
+    next = first;
+    for (G4int i = 0; i < stepsPerEvent; i++) {
+      steppingAction.UserSteppingAction(steps[next].step);
+      next = (next + 1) % steps.size();
+    }
+    Clock::time_point t3 = Clock::now();
+
+    // untimed: the hits must match the steps handed to the SD
+    G4int nExpected = 0;
+    G4double eExpected = 0.;
+    next = first;
+    for (G4int i = 0; i < stepsPerEvent; i++) {
+      G4double eDep = steps[next].step->GetTotalEnergyDeposit();
+      if (eDep > 0.) {
+        nExpected++;
+        eExpected += eDep;
+      }
+      next = (next + 1) % steps.size();
+    }
+    NDDSiPixelHitsCollection* hc = static_cast<NDDSiPixelHitsCollection*>(
+        evt->GetHCofThisEvent()->GetHC(hcID));
+    G4double eHits = 0.;
+    for (size_t i = 0; i < hc->entries(); i++) eHits += (*hc)[i]->GetEnDep();
+    if ((G4int)hc->entries() != nExpected ||
+        std::abs(eHits - eExpected) > 1e-9 * eExpected) {
+      nBadEvents++;
+    }
+
+    sdManager->TerminateCurrentEvent(evt->GetHCofThisEvent());
+    Clock::time_point t4 = Clock::now();
+    eventAction.EndOfEventAction(evt);
+    Clock::time_point t5 = Clock::now();
+
+    tEvent += (t1 - t0) + (t5 - t4);
+    tSD += t2 - t1;
+    tStepping += t3 - t2;
+
+    delete evt;
+  }
+
+  runAction.EndOfRunAction(nullptr);
+
+  G4double nSteps = (G4double)nEvents * stepsPerEvent;
+  auto ns = [](Clock::duration d) {
+    return std::chrono::duration<G4double, std::nano>(d).count();
+  };
+
+  G4cout << G4endl << "NDD microbenchmark: " << nEvents << " events x "
+         << stepsPerEvent << " steps" << G4endl
+         << "  NDDSiPixelSD::ProcessHits           " << ns(tSD) / nSteps
+         << " ns/step" << G4endl
+         << "  NDDSteppingAction::UserSteppingAction " << ns(tStepping) / nSteps
+         << " ns/step" << G4endl
+         << "  NDDEventAction Begin+EndOfEventAction " << ns(tEvent) / nEvents
+         << " ns/event" << G4endl;
+
+  for (auto& s : steps) {
+    delete s.step;
+    delete s.track;
+  }
+
+  if (nBadEvents > 0) {
+    G4cout << "ERROR: " << nBadEvents << " of " << nEvents
+           << " events with hits not matching their steps" << G4endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""Throughput benchmark for one NDD workload.
+
+Runs the NDD executable on a workload macro for a range of thread counts and
+reports events/s, steps/s, peak RSS and the thread-scaling curve. Results are
+compared against bench/baseline.json; the script exits non-zero when a
+workload is slower than its baseline by more than the tolerance, and with
+SKIP_CODE, reported by CTest as skipped, when there is no baseline for it.
+Baselines also record the machine and conditions they were taken under.
+
+    python3 run_bench.py --exe ./NDD --workload bench/protons30keV.mac
+    python3 run_bench.py ... --update-baseline   # store current numbers
+"""
+
+import argparse
+import json
+import os
+import platform
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+# Exit code for a benchmark with nothing to compare against, the tests'
+# SKIP_RETURN_CODE in CMakeLists.txt
+SKIP_CODE = 77
+
+
+def thread_counts(max_threads):
+    counts = []
+    n = 1
+    while n < max_threads:
+        counts.append(n)
+        n *= 2
+    counts.append(max_threads)
+    return counts
+
+
+def run_once(exe, workload, events, threads, workdir):
+    profile = os.path.join(workdir, "profile.json")
+    macro = os.path.join(workdir, "bench.mac")
+    with open(macro, "w") as f:
+        f.write("/control/verbose 0\n")
+        f.write("/run/verbose 1\n")
+        f.write("/run/numberOfThreads {}\n".format(threads))
+        f.write("/NDD/profile/level 1\n")
+        f.write("/NDD/profile/file {}\n".format(profile))
+        f.write("/control/execute {}\n".format(os.path.abspath(workload)))
+        f.write("/run/printProgress 0\n")
+        f.write("/run/beamOn {}\n".format(events))
+
+    log = os.path.join(workdir, "bench.log")
+    start = time.time()
+    with open(log, "w") as out:
+        proc = subprocess.Popen([exe, macro], cwd=workdir, stdout=out,
+                                stderr=subprocess.STDOUT)
+        _, status, usage = os.wait4(proc.pid, 0)
+    wall = time.time() - start
+    if status != 0:
+        sys.exit("NDD failed with status {}, see {}".format(status, log))
+
+    # Event loop time as reported by the run manager, without initialisation
+    with open(log) as f:
+        real = re.findall(r"Real=([0-9.eE+-]+)s", f.read())
+    loop = float(real[-1]) if real else wall
+
+    steps = 0
+    if os.path.exists(profile):
+        with open(profile) as f:
+            steps = json.load(f).get("totalSteps", 0)
+
+    # ru_maxrss is in kB on Linux
+    return {
+        "threads": threads,
+        "wallSeconds": wall,
+        "loopSeconds": loop,
+        "eventsPerSecond": events / loop if loop > 0 else 0.,
+        "stepsPerSecond": steps / loop if loop > 0 else 0.,
+        "peakRSSMB": usage.ru_maxrss / 1024.,
+    }
+
+
+def machine_conditions(args):
+    cpu = platform.processor()
+    if os.path.exists("/proc/cpuinfo"):
+        with open("/proc/cpuinfo") as f:
+            names = re.findall(r"^model name\s*:\s*(.*)$", f.read(), re.M)
+        if names:
+            cpu = names[0]
+    return {
+        "host": platform.node(),
+        "cpu": cpu,
+        "cores": os.cpu_count(),
+        "system": platform.platform(),
+        "events": args.events,
+        "date": time.strftime("%Y-%m-%d"),
+    }
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--exe", required=True, help="NDD executable")
+    parser.add_argument("--workload", required=True, help="workload macro")
+    parser.add_argument("--events", type=int, default=1000)
+    parser.add_argument("--max-threads", type=int, default=os.cpu_count())
+    parser.add_argument("--baseline", default=os.path.join(here, "baseline.json"))
+    parser.add_argument("--tolerance", type=float, default=0.15,
+                        help="allowed relative slowdown against the baseline")
+    parser.add_argument("--output", help="write results as JSON")
+    parser.add_argument("--update-baseline", action="store_true")
+    args = parser.parse_args()
+
+    name = os.path.splitext(os.path.basename(args.workload))[0]
+    exe = os.path.abspath(args.exe)
+
+    results = []
+    for threads in thread_counts(args.max_threads):
+        workdir = tempfile.mkdtemp(prefix="ndd_bench_")
+        try:
+            results.append(run_once(exe, args.workload, args.events, threads, workdir))
+        finally:
+            shutil.rmtree(workdir, ignore_errors=True)
+
+    single = results[0]["eventsPerSecond"]
+    print("Benchmark {} ({} events)".format(name, args.events))
+    print("{:>8} {:>12} {:>14} {:>10} {:>10} {:>12}".format(
+        "threads", "events/s", "steps/s", "speedup", "effic.", "peak RSS MB"))
+    for r in results:
+        speedup = r["eventsPerSecond"] / single if single > 0 else 0.
+        r["speedup"] = speedup
+        print("{:>8} {:>12.1f} {:>14.0f} {:>10.2f} {:>10.2f} {:>12.1f}".format(
+            r["threads"], r["eventsPerSecond"], r["stepsPerSecond"], speedup,
+            speedup / r["threads"], r["peakRSSMB"]))
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump({name: results}, f, indent=2)
+
+    baseline = {}
+    if os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+
+    if args.update_baseline:
+        baseline[name] = {str(r["threads"]): {"eventsPerSecond": r["eventsPerSecond"],
+                                              "peakRSSMB": r["peakRSSMB"]}
+                          for r in results}
+        baseline[name]["conditions"] = machine_conditions(args)
+        with open(args.baseline, "w") as f:
+            json.dump(baseline, f, indent=2, sort_keys=True)
+        print("Baseline for {} updated in {}".format(name, args.baseline))
+        return 0
+
+    if name not in baseline:
+        print("SKIPPED: no baseline for {} in {}; record one on the reference "
+              "machine with --update-baseline".format(name, args.baseline))
+        return SKIP_CODE
+
+    conditions = baseline[name].get("conditions")
+    if conditions:
+        print("Baseline recorded on {host} ({cpu}, {cores} cores) with {events} "
+              "events on {date}".format(**conditions))
+
+    failed = False
+    compared = 0
+    for r in results:
+        ref = baseline[name].get(str(r["threads"]))
+        if not ref:
+            print("{:>8} threads: no baseline".format(r["threads"]))
+            continue
+        compared += 1
+        ratio = r["eventsPerSecond"] / ref["eventsPerSecond"]
+        status = "ok"
+        if ratio < 1. - args.tolerance:
+            status = "REGRESSION"
+            failed = True
+        print("{:>8} threads: {:.2f}x baseline events/s  {}".format(
+            r["threads"], ratio, status))
+    if failed:
+        return 1
+    if compared == 0:
+        print("SKIPPED: the baseline for {} has none of these thread counts; "
+              "set NDD_BENCH_THREADS as when it was recorded".format(name))
+        return SKIP_CODE
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
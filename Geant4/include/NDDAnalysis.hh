@@ -2,8 +2,95 @@
 #define NDDAnalysis_h
 
 #include "g4root.hh"
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include <cmath>
+#include <vector>
 //#include "g4xml.hh"
 //#include "g4csv.hh"
 //#include "g4hdf5.hh"
 
+// Ntuple ids, in the order they are booked by NDDRunAction
+enum NDDNtupleID {
+  kEnergyNtuple = 0,
+  kSpaceTimeNtuple,
+  kHitsNtuple,
+  kPixelNtuple,
+  kVolumesNtuple,
+  kClustersNtuple,
+  kWaveformsNtuple,
+  kTriggerNtuple,
+  kPixelMapNtuple,
+  kPixelSpectraNtuple,
+  kNumberOfNtuples
+};
+
+// Storage of the real-valued hits columns. Quantized columns are integers
+// with a "_q" suffix: positions in units of hitsPositionQuantum, energies
+// in units of hitsEnergyQuantum; times and momenta are stored as floats.
+enum NDDHitsPrecision { kHitsDouble, kHitsFloat, kHitsQuantized };
+
+const G4double hitsPositionQuantum = 0.1 * CLHEP::um;
+const G4double hitsEnergyQuantum = 1. * CLHEP::eV;
+
+// Column ids of the hits ntuple for the selected column set, -1 when a
+// column is not booked. In the per-event layout (/NDD/output/hitsLayout
+// events) the ntuple is called "eventHits" and has one row per event:
+// iD, classification, enPrimary and nHits are scalars, the per-hit
+// quantities are vector columns of length nHits.
+//
+// particle is the PDG code of the depositing track and pixelNumber the
+// pixel of the hit, counted from 1. Files written before /NDD/output/
+// existed hold the placeholders 1 and 0 in these two columns instead.
+struct NDDHitsColumns {
+  NDDHitsPrecision precision;
+  G4bool perEvent;
+  G4int iD, classification, enPrimary, nHits, eDep;
+  G4int x, y, z;
+  G4int px, py, pz;
+  G4int time, particle, pixelNumber, detector;
+};
+
+// Storage of one real-valued vector column of the eventHits ntuple; only
+// the vector matching the hits precision is bound to the ntuple
+struct NDDHitsVector {
+  std::vector<G4double> d;
+  std::vector<G4float> f;
+  std::vector<G4int> q;
+
+  inline void Clear() {
+    d.clear();
+    f.clear();
+    q.clear();
+  }
+  inline void Push(NDDHitsPrecision p, G4double value, G4double quantum) {
+    if (p == kHitsDouble) {
+      d.push_back(value);
+    } else if (p == kHitsQuantized && quantum > 0) {
+      q.push_back((G4int)std::lround(value / quantum));
+    } else {
+      f.push_back(value);
+    }
+  }
+};
+
+struct NDDEventHits {
+  NDDHitsVector eDep, x, y, z, px, py, pz, time;
+  std::vector<G4int> particle, pixelNumber, detector;
+
+  inline void Clear() {
+    eDep.Clear();
+    x.Clear();
+    y.Clear();
+    z.Clear();
+    px.Clear();
+    py.Clear();
+    pz.Clear();
+    time.Clear();
+    particle.clear();
+    pixelNumber.clear();
+    detector.clear();
+  }
+};
+
 #endif
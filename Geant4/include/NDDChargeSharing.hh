@@ -0,0 +1,69 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDChargeSharing_h
+#define NDDChargeSharing_h 1
+
+#include "G4Types.hh"
+#include "NDDSiPixelHit.hh"
+
+#include <vector>
+
+class NDDChargeSharingMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Energy seen by one pixel from one hit
+struct NDDPixelDeposit {
+  G4int pixelNumber;
+  G4double eDep;
+  G4double time;
+};
+
+/// Splits the hits of an event between adjacent pixels (/NDD/sharing/).
+///
+/// The charge of a hit arrives at the pixels as a Gaussian cloud whose
+/// lateral width grows with the drift distance d to the pixel side,
+/// sigma^2 = sigma0^2 + width^2 d / thickness, so width is the spread of
+/// a cloud drifting through the full detector. The pixels are at the back,
+/// at z = thickness in the pixel frame. Each neighbour in the NDDPixelMap
+/// gets the tail of the cloud beyond the edge it shares with the hit's
+/// pixel, 1/2 erfc(e / sqrt(2) sigma) for an edge at distance e, taken from
+/// a table; the hit's pixel keeps the rest. Near a corner the two tails
+/// overlap slightly, which this neglects. Charge beyond an edge of the
+/// array is lost. Hits further than five sigma from every edge, nearly all
+/// of them for 7 mm pixels, stay whole without any lookup.
+///
+/// The shared deposits replace the hits in the pixel energies, the pixel
+/// spectra and the trigger; the hits themselves are unchanged. Each worker
+/// owns one instance; the widths are shared and set on the master.
+
+class NDDChargeSharing {
+ public:
+  NDDChargeSharing();
+
+  // /NDD/sharing/ commands; created and deleted by the master run action
+  static void CreateMessenger();
+  static void DeleteMessenger();
+
+  static inline G4bool IsEnabled() { return width > 0 || initialWidth > 0; }
+  static inline void SetWidth(G4double w) { width = w; }
+  static inline void SetInitialWidth(G4double w) { initialWidth = w; }
+  static inline void SetThickness(G4double t) { thickness = t; }
+
+  const std::vector<NDDPixelDeposit>& Share(NDDSiPixelHitsCollection* hc);
+
+ private:
+  void ShareHit(const NDDSiPixelHit* hit);
+  // 1/2 erfc(u / sqrt(2)), u in units of sigma
+  static G4double Tail(G4double u);
+
+  static NDDChargeSharingMessenger* messenger;
+  static G4double width;
+  static G4double initialWidth;
+  static G4double thickness;
+
+  std::vector<NDDPixelDeposit> deposits;
+};
+
+#endif
@@ -0,0 +1,31 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDChargeSharingMessenger_h
+#define NDDChargeSharingMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithADoubleAndUnit;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// /NDD/sharing/ commands of the NDDChargeSharing.
+
+class NDDChargeSharingMessenger : public G4UImessenger {
+ public:
+  NDDChargeSharingMessenger();
+  virtual ~NDDChargeSharingMessenger();
+
+  virtual void SetNewValue(G4UIcommand*, G4String);
+
+ private:
+  G4UIdirectory* sharingDir;
+
+  G4UIcmdWithADoubleAndUnit* sharingWidthCmd;
+  G4UIcmdWithADoubleAndUnit* sharingInitialWidthCmd;
+  G4UIcmdWithADoubleAndUnit* sharingThicknessCmd;
+};
+
+#endif
@@ -16,9 +16,22 @@
 
 #include "G4ThreeVector.hh"
 
+#include <vector>
+
 class G4UserLimits;
 class NDDDetectorMessenger;
 
+/// A silicon detector stack, placed from the logical volumes shared by all
+/// detectors with its index as copy number. It looks along z towards the
+/// decay region at the origin.
+struct NDDDetector {
+  G4String name;
+  // front of the dead layer, on the detector axis
+  G4ThreeVector face;
+  // +1 when the stack lies behind the face at larger z, looking towards -z
+  G4int side;
+};
+
 class NDDDetectorConstruction : public G4VUserDetectorConstruction {
  public:
   NDDDetectorConstruction();
@@ -30,7 +43,13 @@ class NDDDetectorConstruction : public G4VUserDetectorConstruction {
   inline void AddSourceID(G4int i) { sourceIDs.push_back(i); };
   inline void AddSourcePosition(G4ThreeVector v) { sourcePos.push_back(v); };
   inline void SetPixelRings(G4int r) { pixelRings = r; };
-  inline void SetDetectorPosition(G4ThreeVector v) { detectorPosition = v;}
+  // the first call replaces the default detector "E" at z = 10 mm
+  void AddDetector(const G4String& name);
+  // of the last added detector
+  void SetDetectorPosition(G4ThreeVector v);
+  inline const std::vector<NDDDetector>& GetDetectors() const {
+    return detectors;
+  }
 
  private:
   void BuildWorld();
@@ -44,7 +63,8 @@ class NDDDetectorConstruction : public G4VUserDetectorConstruction {
 
   void BuildSource(G4int, G4ThreeVector);
 
-  G4ThreeVector detectorPosition;
+  std::vector<NDDDetector> detectors;
+  G4bool defaultDetector;
 
   NDDDetectorMessenger* detMess;
 
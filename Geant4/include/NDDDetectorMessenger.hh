@@ -5,9 +5,14 @@
 #include "G4UImessenger.hh"
 
 class NDDDetectorConstruction;
+class G4UIcommand;
 class G4UIdirectory;
 class G4UIcmdWith3VectorAndUnit;
 class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
 
 class NDDDetectorMessenger : public G4UImessenger {
  public:
@@ -22,9 +27,45 @@ class NDDDetectorMessenger : public G4UImessenger {
   G4UIdirectory* geomDir;
   G4UIdirectory* sourceDir;
   G4UIcmdWith3VectorAndUnit* sourcePosCmd;
+  G4UIcmdWithAString* addDetectorCmd;
   G4UIcmdWith3VectorAndUnit* detPosCmd;
   G4UIcmdWithAnInteger* sourceIDCmd;
   G4UIcmdWithAnInteger* pixelRingsCmd;
+
+  G4UIdirectory* fieldDir;
+  G4UIcmdWithAString* fieldMapCmd;
+  G4UIcmdWithADouble* fieldScaleCmd;
+  G4UIcmdWith3VectorAndUnit* fieldOffsetCmd;
+  G4UIcmdWithAString* fieldStepperCmd;
+  G4UIcmdWithADoubleAndUnit* fieldMinStepCmd;
+  G4UIcmdWithADoubleAndUnit* fieldDeltaChordCmd;
+  G4UIcmdWithADoubleAndUnit* fieldDeltaOneStepCmd;
+  G4UIcmdWithADoubleAndUnit* fieldDeltaIntersectionCmd;
+  G4UIcmdWithADouble* fieldEpsilonMinCmd;
+  G4UIcmdWithADouble* fieldEpsilonMaxCmd;
+
+  G4UIdirectory* electricDir;
+  G4UIcmdWithADoubleAndUnit* electricVoltageCmd;
+  G4UIcmdWithADoubleAndUnit* electricGapCmd;
+  G4UIcmdWithADoubleAndUnit* electricRadiusCmd;
+  G4UIcmdWithAString* electricMapCmd;
+  G4UIcmdWithADouble* electricScaleCmd;
+  G4UIcmdWith3VectorAndUnit* electricOffsetCmd;
+
+  G4UIdirectory* guidingCentreDir;
+  G4UIcmdWithABool* guidingCentreEnableCmd;
+  G4UIcmdWithADoubleAndUnit* guidingCentreMaxStepCmd;
+  G4UIcmdWithADouble* guidingCentreAdiabaticityCmd;
+  G4UIcmdWithADouble* guidingCentreMarginCmd;
+  G4UIcmdWithADoubleAndUnit* guidingCentreDistanceCmd;
+
+  // volume of the following /NDD/limits/ commands
+  G4String limitsVolume;
+  G4UIdirectory* limitsDir;
+  G4UIcmdWithAString* limitsVolumeCmd;
+  G4UIcmdWithADoubleAndUnit* limitsMaxTimeCmd;
+  G4UIcommand* limitsMinEkinCmd;
+  G4UIcmdWithADoubleAndUnit* limitsMaxDistanceCmd;
 };
 
 #endif
@@ -0,0 +1,115 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDDigitizer_h
+#define NDDDigitizer_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "NDDPixelResponseMap.hh"
+#include "NDDPulseTemplates.hh"
+#include "NDDSiPixelHit.hh"
+#include "NDDWaveformBatch.hh"
+
+#include <vector>
+
+class NDDDigitizerMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+struct NDDPixelWaveform {
+  G4int pixelNumber;
+  std::vector<G4double> samples;  // induced charge, keV equivalent
+  NDDPulseFeatures features;      // times from the first sample
+};
+
+/// Pixel waveforms from the hits of an event, without leaving Geant4
+/// (/NDD/digitizer/).
+///
+/// Each hit is split into two carrier clouds drifting straight along z, one
+/// to the pixel electrodes and one to the back contact. The charge induced
+/// on a pixel follows Shockley-Ramo: the carrier moves through the grid
+/// planes of the NDDPixelResponseMap at the times given by the drift time
+/// column under the hit, and the signal changes by the difference of the
+/// pixel's weighting potential between consecutive planes, linear in time
+/// in between. Neighbouring pixels use the same map shifted to their own
+/// centre, so they see the transient induced charge that integrates to
+/// zero. Waveforms start preTrigger before the earliest hit.
+///
+/// With a template library (/NDD/digitizer/templates) each hit instead adds
+/// the interpolated unit-charge waveform for its depth and position relative
+/// to every pixel in reach, shifted to the hit time. This skips the drift
+/// entirely and takes precedence over the map; the sample period is then
+/// that of the library.
+///
+/// The waveforms of an event can then be shaped (/NDD/digitizer/shaper)
+/// and their amplitude, 10% time and 10-90% rise time extracted, all in one
+/// NDDWaveformBatch.
+///
+/// Each worker owns one instance; the map and the sampling are shared and
+/// set on the master.
+
+class NDDDigitizer {
+ public:
+  NDDDigitizer();
+
+  // /NDD/digitizer/ commands; created and deleted by the master run action
+  static void CreateMessenger();
+  static void DeleteMessenger();
+
+  static inline G4bool IsEnabled() { return responseMap || templates; }
+  static G4bool SetResponseMap(const G4String& filename);
+  static G4bool SetTemplates(const G4String& filename);
+  static inline void SetSamplePeriod(G4double t) { samplePeriod = t; }
+  static inline void SetNumberOfSamples(G4int n) { nSamples = n; }
+  static inline void SetPreTrigger(G4double t) { preTrigger = t; }
+  static inline void SetShaping(const NDDShaping& s) { shaping = s; }
+  static inline G4double GetSamplePeriod() {
+    return templates ? templates->GetPeriod() : samplePeriod;
+  }
+  static inline G4int GetNumberOfSamples() { return nSamples; }
+
+  const std::vector<NDDPixelWaveform>& Digitize(NDDSiPixelHitsCollection* hc);
+  inline G4double GetStartTime() const { return startTime; }
+
+ private:
+  void AddHit(const NDDSiPixelHit* hit);
+  void AddCarrier(const NDDPixelResponseMap::Column& own, G4bool collected,
+                  G4double z0, G4double t0, G4double scale);
+  void AddSegment(G4int waveform, G4double ta, G4double tb, G4double dQ);
+  void AddTemplateHit(const NDDSiPixelHit* hit);
+  void AddTemplate(G4int waveform, const NDDPulseTemplates::Weights& w,
+                   G4int first, G4double fraction, G4double scale);
+  G4int GetWaveform(G4int pixelNumber);
+
+  static NDDDigitizerMessenger* messenger;
+  static const NDDPixelResponseMap* responseMap;
+  static const NDDPulseTemplates* templates;
+  static G4double samplePeriod;
+  static G4int nSamples;
+  static G4double preTrigger;
+  static NDDShaping shaping;
+
+  G4double startTime;
+  std::vector<NDDPixelWaveform> waveforms;
+  std::vector<std::vector<G4double> > tails;  // step changes, summed at the end
+  std::vector<G4int> waveformOf;               // index in waveforms per pixel
+
+  // per hit: the pixels in reach and their map columns, reused
+  struct Target {
+    G4int waveform;
+    NDDPixelResponseMap::Column column;
+    G4double w0;  // weighting potential at the hit
+  };
+  std::vector<Target> targets;
+  std::vector<G4int> inReach;  // pixel numbers
+  std::vector<G4double> potential;  // nz planes per target
+  std::vector<G4double> ownTimes;
+  std::vector<G4int> nodePlane;
+  std::vector<G4double> nodeTime;
+  std::vector<G4double> combined;
+  NDDWaveformBatch batch;
+  std::vector<NDDPulseFeatures> features;
+};
+
+#endif
@@ -0,0 +1,37 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDDigitizerMessenger_h
+#define NDDDigitizerMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// /NDD/digitizer/ commands of the NDDDigitizer.
+
+class NDDDigitizerMessenger : public G4UImessenger {
+ public:
+  NDDDigitizerMessenger();
+  virtual ~NDDDigitizerMessenger();
+
+  virtual void SetNewValue(G4UIcommand*, G4String);
+
+ private:
+  G4UIdirectory* digitizerDir;
+
+  G4UIcmdWithAString* digitizerMapCmd;
+  G4UIcmdWithAString* digitizerTemplatesCmd;
+  G4UIcmdWithADoubleAndUnit* digitizerPeriodCmd;
+  G4UIcmdWithAnInteger* digitizerSamplesCmd;
+  G4UIcmdWithADoubleAndUnit* digitizerPreTriggerCmd;
+  G4UIcommand* digitizerShaperCmd;
+};
+
+#endif
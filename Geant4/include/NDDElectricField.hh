@@ -0,0 +1,74 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDElectricField_h
+#define NDDElectricField_h 1
+
+#include "G4ElectroMagneticField.hh"
+#include "G4MagneticField.hh"
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "NDDFieldMap.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Electric field accelerating charged particles onto the detector at high
+/// voltage (/NDD/field/electric/), on top of the magnetic field of
+/// NDDMagneticField if there is one.
+///
+/// The field is either uniform along z, from ground at the gap in front
+/// of each detector face to the detector voltage at the face, within a
+/// radius of the detector axis, or read from an NDDFieldMap in kV/mm.
+/// It only covers the region near the detector: points outside its
+/// bounding box get the magnetic field alone without touching the
+/// electric map, and a map keeps a cell cache of its own next to the
+/// magnetic one, so tracks crossing both do not evict each other's cells.
+
+class NDDElectricField : public G4ElectroMagneticField {
+ public:
+  NDDElectricField(const G4MagneticField* magnetic);
+  virtual ~NDDElectricField();
+
+  virtual void GetFieldValue(const G4double point[4], G4double* field) const;
+  virtual G4bool DoesFieldChangeEnergy() const { return true; }
+
+  static inline G4bool IsEnabled() {
+    return fieldMap != nullptr || voltage != 0;
+  }
+  static inline void SetVoltage(G4double v) { voltage = v; }
+  static inline void SetGap(G4double g) { gap = g; }
+  static inline void SetRadius(G4double r) { radius = r; }
+  static G4bool SetMap(const G4String& filename);
+  static inline void SetScale(G4double s) { scale = s; }
+  static inline void SetOffset(const G4ThreeVector& v) { offset = v; }
+
+  // front of the dead layer of every detector, on its axis, from the
+  // geometry; side +1 for a detector looking towards -z
+  static inline void ClearDetectorFaces() { faces.clear(); }
+  static inline void AddDetectorFace(const G4ThreeVector& v, G4int side) {
+    faces.push_back(Face{v, side});
+  }
+
+ private:
+  struct Face {
+    G4ThreeVector position;
+    G4int side;
+  };
+
+  static G4double voltage;
+  static G4double gap;
+  static G4double radius;
+  static const NDDFieldMap* fieldMap;
+  static G4double scale;
+  static G4ThreeVector offset;
+  static std::vector<Face> faces;
+
+  const G4MagneticField* magnetic;
+  NDDFieldMapInterpolator* interpolator;
+  G4double uniformField;
+  G4double lower[3], upper[3];
+};
+
+#endif
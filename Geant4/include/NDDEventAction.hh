@@ -10,6 +10,11 @@
 #include "G4ThreeVector.hh"
 
 #include "G4UserEventAction.hh"
+#include "NDDSiPixelHit.hh"
+#include "NDDHitClusterer.hh"
+#include "NDDChargeSharing.hh"
+#include "NDDDigitizer.hh"
+#include "NDDTrigger.hh"
 
 #include <vector>
 
@@ -20,12 +25,16 @@ struct VolumeVisit {
 };
 
 class NDDRunAction;
+class NDDSurrogateEventInformation;
+class NDDProfiler;
+class NDDHitStream;
+class NDDPassiveSD;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class NDDEventAction : public G4UserEventAction {
  public:
-  NDDEventAction();
+  NDDEventAction(NDDRunAction*);
   virtual ~NDDEventAction();
 
  public:
@@ -64,6 +73,10 @@ class NDDEventAction : public G4UserEventAction {
 
  private:
   G4int ClassifyEvent();
+  void EndOfSurrogateEvent(G4int, const NDDSurrogateEventInformation*);
+  G4bool SelectEvent(const std::vector<G4double>&, G4double&);
+  void CheckPrecision(const std::vector<G4double>&);
+  void CollectPassiveDeposits();
 
   G4double enPrimary;
   G4double enDepSi;
@@ -71,6 +84,7 @@ class NDDEventAction : public G4UserEventAction {
   G4double enDepFoil;
   G4double enDepCarrier;
   G4double enDepSourceHolder;
+  G4double enDepBacking;
   G4double poeXSi, poeYSi;
   G4double poeXF, poeYF;
   G4double timeSi;
@@ -79,19 +93,36 @@ class NDDEventAction : public G4UserEventAction {
   G4double angleSiOut, angleSourceOut;
 
   G4int SiHCiD;
+  NDDPassiveSD* deadSD;
+  NDDPassiveSD* backingSD;
+  NDDPassiveSD* foilSD;
+  NDDPassiveSD* carrierSD;
+  NDDPassiveSD* sourceHolderSD;
 
   G4int classification;
 
+  NDDRunAction* runAction;
+  NDDProfiler* profiler;
+  NDDHitStream* hitStream;
+  NDDHitClusterer clusterer;
+  NDDChargeSharing sharing;
+  NDDDigitizer digitizer;
+  NDDTrigger trigger;
+
   std::vector<VolumeVisit> visitedVolumes;
 
   void Clear();
   void FillEnergyTuple(G4int, G4int, G4double, G4double, G4double,
-      G4double, G4double, G4double, G4double);
+      G4double, G4double, G4double, G4double, G4double, G4int, G4double);
   void FillSpacetimeTuple(G4int, G4int, G4double, G4double, G4double, G4double, G4double);
-  void FillHitsTuple(G4int, G4int, G4double, G4double, G4double, G4double, G4double,
-      G4double, G4double, G4double, G4double, G4int, G4int);
+  void FillHitsTuple(G4int, G4int, G4double, const NDDSiPixelHit*);
+  void FillEventHitsTuple(G4int, G4int, G4double, NDDSiPixelHitsCollection*);
   void FillPixelTuple(G4int, G4int, G4double, std::vector<G4double>&);
   void FillVolumesTuple(G4int, G4int, G4double, G4double, G4double, G4String);
+  void FillClustersTuple(G4int, G4int, const std::vector<NDDHitCluster>&);
+  void FillWaveformsTuple(G4int, const std::vector<NDDPixelWaveform>&);
+  void FillTriggerTuple(G4int, const std::vector<NDDTriggerRecord>&);
+  void FillPixelSpectra(const std::vector<G4double>&);
   void FillH1Hist(G4int ih, G4double xbin, G4double weight = 1.);
   void FillH2Hist(G4int ih, G4double xbin, G4double ybin, G4double weight = 1.);
 };
@@ -0,0 +1,75 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDEventFilter_h
+#define NDDEventFilter_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <atomic>
+#include <vector>
+
+class NDDEventFilterMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Event-level selection of the per-event ntuple rows (/NDD/filter/).
+///
+/// An event passes when it satisfies every configured criterion: a minimum
+/// Si energy, a minimum pixel multiplicity and minimum counts in the digits
+/// of the event classification. Rejected events are dropped from the
+/// ntuples, except one in every `prescale` which is kept with weight equal
+/// to the prescale factor. Histograms and pixel spectra still see every
+/// event. Like the precision monitor, configuration is only changed from
+/// the master between runs and the counters are atomic; the master stores
+/// them in the "eventFilter" histogram for normalization.
+
+class NDDEventFilter {
+ public:
+  enum Decision { kRejected = 0, kAccepted, kPrescaled };
+
+  static NDDEventFilter* Instance();
+
+  // /NDD/filter/ commands; created and deleted by the master run action
+  static void CreateMessenger();
+  static void DeleteMessenger();
+
+  inline void SetMinEnSi(G4double e) { minEnSi = e; }
+  inline void SetMinPixels(G4int n) { minPixels = n; }
+  void SetMinClassification(const G4String& field, G4int min);
+  inline void SetPrescale(G4int n) { prescale = n > 0 ? n : 0; }
+  void Clear();
+
+  G4bool IsActive() const;
+
+  void Reset();
+  Decision Select(G4double enDepSi, G4int classification,
+                  const std::vector<G4double>& pixelEnDep);
+
+  // row weight of a kept event, so that weighted sums are unbiased
+  inline G4double GetWeight(Decision d) const {
+    return d == kPrescaled ? prescale : 1.;
+  }
+
+  void Report() const;
+  void FillHistogram(G4int ih) const;
+
+ private:
+  static NDDEventFilterMessenger* messenger;
+
+  NDDEventFilter();
+
+  G4double minEnSi;
+  G4int minPixels;
+  // SiHits, backscatters, deadHits, foilHits: digits 3 to 0
+  G4int minDigits[4];
+  G4int prescale;
+
+  std::atomic<G4long> nEvents;
+  std::atomic<G4long> nAccepted;
+  std::atomic<G4long> nRejected;
+  std::atomic<G4long> nPrescaled;
+};
+
+#endif
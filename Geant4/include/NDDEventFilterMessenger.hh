@@ -0,0 +1,36 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDEventFilterMessenger_h
+#define NDDEventFilterMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// /NDD/filter/ commands of the NDDEventFilter.
+
+class NDDEventFilterMessenger : public G4UImessenger {
+ public:
+  NDDEventFilterMessenger();
+  virtual ~NDDEventFilterMessenger();
+
+  virtual void SetNewValue(G4UIcommand*, G4String);
+
+ private:
+  G4UIdirectory* filterDir;
+
+  G4UIcmdWithADoubleAndUnit* filterMinEnSiCmd;
+  G4UIcmdWithAnInteger* filterMinPixelsCmd;
+  G4UIcommand* filterRequireCmd;
+  G4UIcmdWithAnInteger* filterPrescaleCmd;
+  G4UIcmdWithoutParameter* filterClearCmd;
+};
+
+#endif
@@ -0,0 +1,93 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDFieldMap_h
+#define NDDFieldMap_h 1
+
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// A magnetic or electric field on a regular grid, either axisymmetric in
+/// (r, z) or in (x, y, z), in the frame of the map (see /NDD/field/offset).
+///
+/// The file is binary, in the byte order of the machine, as written by
+/// the NDDFieldMapConvert tool from a text table:
+///
+///   char[8]    "NDDFMAP1"
+///   int32      dimension, 2 for (r, z) or 3 for (x, y, z)
+///   int32[3]   number of points along each axis, 1 along y in 2D
+///   double[3]  first point [mm]
+///   double[3]  last point [mm]
+///   float[]    (Br, Bz) or (Bx, By, Bz) per point, z fastest, then y, x,
+///              in T for magnetic and kV/mm for electric maps
+///
+/// The components of a point are stored together and z runs fastest, so
+/// a track moving along the axis, as the electrons guided to the detector
+/// do, reads consecutive memory. Maps are loaded once per process and
+/// shared read-only by all threads; the field values are stored as floats
+/// in Geant4 units.
+
+class NDDFieldMap {
+ public:
+  // unit of the values in the file, tesla or kilovolt / mm
+  static const NDDFieldMap* Load(const G4String& filename, G4double unit);
+
+  inline G4int GetDimension() const { return dimension; }
+  inline G4int GetComponents() const { return dimension == 2 ? 2 : 3; }
+  inline G4int GetN(G4int axis) const { return n[axis]; }
+  inline G4double GetMin(G4int axis) const { return min[axis]; }
+  inline G4double GetStep(G4int axis) const { return step[axis]; }
+
+  // the components of point (i, j, k), j = 0 in 2D
+  inline const G4float* GetPoint(G4int i, G4int j, G4int k) const {
+    return &values[(((size_t)i * n[1] + j) * n[2] + k) * GetComponents()];
+  }
+
+ private:
+  NDDFieldMap(const G4String& filename);
+  G4bool Read(G4double unit);
+
+  G4String filename;
+  G4int dimension;
+  G4int n[3];
+  G4double min[3], step[3];
+  std::vector<G4float> values;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Interpolation in an NDDFieldMap, placed at an offset and scaled:
+/// trilinear in (x, y, z), or bilinear in (r, z) for axisymmetric maps,
+/// zero outside the map.
+///
+/// Consecutive calls mostly fall into the same grid cell, so it keeps the
+/// corner values of the last cell and only goes back to the map when a
+/// point leaves it. Every field of every thread has its own.
+
+class NDDFieldMapInterpolator {
+ public:
+  NDDFieldMapInterpolator(const NDDFieldMap* map, G4double scale,
+                          const G4ThreeVector& offset);
+
+  // the three components at point, false and zero outside the map
+  G4bool Evaluate(const G4double point[3], G4double* value) const;
+
+ private:
+  void LoadCell(G4int i, G4int j, G4int k) const;
+
+  const NDDFieldMap* map;
+  G4double scale;
+  G4ThreeVector offset;
+
+  // corners of the last cell, (i, j, k) with j, k fastest, components
+  // together; in 2D only the four (i, k) corners
+  mutable G4long cell;
+  mutable G4double corners[8][3];
+};
+
+#endif
@@ -0,0 +1,91 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDGuidingCentreModel_h
+#define NDDGuidingCentreModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "G4ThreeVector.hh"
+
+class G4Field;
+class G4Navigator;
+class G4Region;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Fast transport of charged particles through the spectrometer vacuum in
+/// the adiabatic guiding-centre approximation (/NDD/guidingCentre/).
+///
+/// Instead of following every turn of the helix, the guiding centre moves
+/// along the field line at the parallel velocity plus the grad-B and
+/// curvature drift. The magnetic moment p_perp^2 / B is conserved, which
+/// fixes the pitch angle everywhere; where the parallel momentum vanishes
+/// the particle is reflected, a magnetic mirror. The time of flight and
+/// the path length are integrated along the way. The kinetic energy is
+/// conserved, so the residual gas is ignored while the model is in charge.
+///
+/// The model triggers for tracks in the world volume when the field is
+/// adiabatic, i.e. the gyroradius is small against the length over which
+/// |B| changes, and the nearest material is further away than the
+/// hand-back distance plus /NDD/guidingCentre/distance. It gives the
+/// track back to full tracking, with the gyration phase advanced over the
+/// flight, when it comes within the hand-back distance of material, at
+/// the edge of the field, in an electric field (NDDElectricField) or
+/// where adiabaticity breaks. Every worker owns its model in the world
+/// region; the settings are shared and set on the master. Without
+/// /NDD/guidingCentre/enable, NDDPhysicsList attaches no fast simulation
+/// process, so full tracking is exactly as without the model.
+///
+/// validation/check_guiding_centre.py compares the model against full
+/// tracking in a magnetic bottle, see validation/guidingCentre.mac.
+
+class NDDGuidingCentreModel : public G4VFastSimulationModel {
+ public:
+  NDDGuidingCentreModel(G4Region* region);
+  virtual ~NDDGuidingCentreModel();
+
+  virtual G4bool IsApplicable(const G4ParticleDefinition& particle);
+  virtual G4bool ModelTrigger(const G4FastTrack& fastTrack);
+  virtual void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+  static inline G4bool IsEnabled() { return enabled; }
+  static inline void SetEnabled(G4bool b) { enabled = b; }
+  static inline void SetMaxStep(G4double s) { maxStep = s; }
+  static inline void SetAdiabaticity(G4double a) { adiabaticity = a; }
+  static inline void SetMargin(G4double m) { margin = m; }
+  static inline void SetDistance(G4double d) { distance = d; }
+
+  // the model of the calling thread, in the world region
+  static void Install();
+
+ private:
+  G4bool Sample(const G4ThreeVector& position, G4double time,
+                G4ThreeVector& b) const;
+  G4ThreeVector Gradient(const G4ThreeVector& position, G4double time) const;
+  G4bool Velocity(const G4ThreeVector& b, const G4ThreeVector& gradient,
+                  G4ThreeVector& velocity) const;
+  G4double Safety(const G4ThreeVector& position);
+  inline G4double HandBack(G4double gyroradius) const {
+    return margin * gyroradius + distance;
+  }
+
+  static G4bool enabled;
+  static G4double maxStep;
+  static G4double adiabaticity;
+  static G4double margin;
+  static G4double distance;
+
+  G4Navigator* navigator;
+  const G4Field* field;
+
+  // the guiding centre of the track accepted by ModelTrigger
+  G4ThreeVector centre;
+  G4ThreeVector gyration;
+  G4double charge, momentum, energy, moment, sign;
+
+  // a DoIt that could not move the track, not to be triggered again
+  G4int stalledTrack;
+  G4double stalledTime;
+};
+
+#endif
@@ -0,0 +1,69 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDHitClusterer_h
+#define NDDHitClusterer_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+#include "NDDSiPixelHit.hh"
+
+#include <utility>
+#include <vector>
+
+class NDDHitClustererMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+struct NDDHitCluster {
+  G4double eDep;
+  G4ThreeVector pos;  // energy weighted
+  G4double time;      // earliest hit
+  G4int pixelNumber;  // pixel of the largest deposit
+  G4int nHits;
+};
+
+/// Merges the hits of an event into charge clouds (/NDD/cluster/radius).
+///
+/// Two hits belong to the same cluster when they are closer than the
+/// radius, directly or through a chain of hits, as in the SSD stage's
+/// cluster_detector_hits. Hits are binned in a grid with the radius as cell
+/// size, kept as a sorted list of (cell, hit), so only the 27 neighbouring
+/// cells are searched per hit. Each worker owns one instance; the radius is
+/// shared and set on the master.
+
+class NDDHitClusterer {
+ public:
+  NDDHitClusterer();
+
+  // /NDD/cluster/ commands; created and deleted by the master run action
+  static void CreateMessenger();
+  static void DeleteMessenger();
+
+  static inline G4bool IsEnabled() { return radius > 0; }
+  static inline void SetRadius(G4double r) { radius = r; }
+  static inline G4double GetRadius() { return radius; }
+
+  const std::vector<NDDHitCluster>& Cluster(NDDSiPixelHitsCollection* hc);
+
+ private:
+  typedef G4long CellKey;
+
+  CellKey GetKey(G4long ix, G4long iy, G4long iz) const;
+  void Link(NDDSiPixelHitsCollection* hc, G4int i, CellKey key);
+  G4int Find(G4int i);
+
+  static NDDHitClustererMessenger* messenger;
+  static G4double radius;
+
+  // reused between events to avoid reallocating
+  std::vector<std::pair<CellKey, G4int> > grid;
+  std::vector<G4long> cellIndex;
+  std::vector<G4int> parent;
+  std::vector<G4int> clusterOf;
+  std::vector<G4int> firstHit;
+  std::vector<G4double> maxDep;
+  std::vector<NDDHitCluster> clusters;
+};
+
+#endif
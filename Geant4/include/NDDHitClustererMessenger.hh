@@ -0,0 +1,29 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDHitClustererMessenger_h
+#define NDDHitClustererMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithADoubleAndUnit;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// /NDD/cluster/ commands of the NDDHitClusterer.
+
+class NDDHitClustererMessenger : public G4UImessenger {
+ public:
+  NDDHitClustererMessenger();
+  virtual ~NDDHitClustererMessenger();
+
+  virtual void SetNewValue(G4UIcommand*, G4String);
+
+ private:
+  G4UIdirectory* clusterDir;
+
+  G4UIcmdWithADoubleAndUnit* clusterRadiusCmd;
+};
+
+#endif
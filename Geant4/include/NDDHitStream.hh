@@ -0,0 +1,103 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDHitStream_h
+#define NDDHitStream_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "NDDSiPixelHit.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+class NDDHitStreamMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Streams the hits of finished events into a POSIX shared-memory ring
+/// buffer (/NDD/output/stream), so that a consumer such as the SSD drift
+/// stage (SSD/StreamGeant4Hits.jl) can start while Geant4 is still running.
+///
+/// Layout of /dev/shm/<name>, all integers little endian:
+///
+///   header, 64 bytes
+///     0  char[8]  magic "NDDHITS2"
+///     8  uint32   header size (64)
+///    12  uint32   hit size in bytes (32)
+///    16  uint64   capacity of the data region in bytes
+///    24  uint64   write offset, total bytes published (producer)
+///    32  uint64   read offset, total bytes consumed (consumer)
+///    40  uint32   finished, set to 1 when the producer closes
+///    44  uint32   reserved
+///    48  uint64   events published
+///    56  uint64   reserved
+///   data region, capacity bytes, used as a ring; a record starts at
+///   (offset mod capacity), is a multiple of 8 bytes and never wraps:
+///     uint32 nHits, int32 eventID, then nHits times
+///     float32 x, y, z [mm], float32 eDep [keV], float32 time [ns],
+///     int32 pixelNumber, int32 detector, int32 reserved
+///   nHits = 0xFFFFFFFF pads the rest of the region, the next record
+///   starts at the beginning; nHits = 0xFFFFFFFE marks the end of a run.
+///
+/// The producer only advances the write offset once a record is complete.
+/// While the consumer is more than `capacity` bytes behind, a worker waits
+/// for it. Only with a non-negative stream timeout does it give up and drop
+/// its event after that long; the dropped records are counted and reported
+/// at the end of the run. Workers encode their
+/// events on their own and only take the shared mutex to copy a complete
+/// record into the ring, so records of different threads are never
+/// interleaved and no worker sleeps while holding it.
+
+class NDDHitStream {
+ public:
+  static NDDHitStream* Instance();
+
+  // /NDD/output/stream command; created and deleted by the master run action
+  static void CreateMessenger();
+  static void DeleteMessenger();
+
+  // timeout: how long a full ring is waited for before dropping an event,
+  // negative to wait as long as it takes
+  G4bool Open(const G4String& name, G4double capacityMB, G4double timeout);
+  void Close();
+  inline G4bool IsOpen() const { return data != nullptr; }
+
+  void Publish(G4int eventID, NDDSiPixelHitsCollection* hc);
+  void EndOfRun();
+
+ private:
+  static NDDHitStreamMessenger* messenger;
+
+  NDDHitStream();
+  ~NDDHitStream();
+
+  struct Header {
+    char magic[8];
+    uint32_t headerSize;
+    uint32_t hitSize;
+    uint64_t capacity;
+    std::atomic<uint64_t> writeOffset;
+    std::atomic<uint64_t> readOffset;
+    std::atomic<uint32_t> finished;
+    uint32_t reserved0;
+    std::atomic<uint64_t> nEvents;
+    uint64_t reserved1;
+  };
+
+  // waits for space without the lock, drops the record after the timeout
+  void Write(const std::vector<char>& record, G4int eventID);
+  // under the lock, false while the ring has no space for the record
+  G4bool TryWrite(const std::vector<char>& record);
+
+  G4String name;
+  G4double timeout;
+  Header* header;
+  char* data;
+  size_t mappedSize;
+  G4long dropped;
+  G4bool warnedFull;
+};
+
+#endif
@@ -0,0 +1,27 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDHitStreamMessenger_h
+#define NDDHitStreamMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIcommand;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// /NDD/output/stream, the command of the NDDHitStream. The rest of
+/// /NDD/output/ belongs to the run action, see NDDRunMessenger.
+
+class NDDHitStreamMessenger : public G4UImessenger {
+ public:
+  NDDHitStreamMessenger();
+  virtual ~NDDHitStreamMessenger();
+
+  virtual void SetNewValue(G4UIcommand*, G4String);
+
+ private:
+  G4UIcommand* streamCmd;
+};
+
+#endif
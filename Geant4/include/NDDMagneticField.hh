@@ -0,0 +1,59 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDMagneticField_h
+#define NDDMagneticField_h 1
+
+#include "G4MagneticField.hh"
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "NDDFieldMap.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Integration of tracks in the field, see /NDD/field/
+struct NDDFieldIntegration {
+  G4String stepper;  // ClassicalRK4, CashKarpRKF45 or DormandPrince745
+  G4double minStep;
+  G4double deltaChord;
+  G4double deltaOneStep;
+  G4double deltaIntersection;
+  G4double epsilonMin, epsilonMax;
+};
+
+/// Magnetic field from an NDDFieldMap (/NDD/field/), trilinear in (x, y, z)
+/// or bilinear in (r, z) for axisymmetric maps, zero outside the map.
+///
+/// The map is shared by all threads, but every worker owns its own field,
+/// built with its field manager and chord finder in ConstructSDandField,
+/// together with the electric field of NDDElectricField if one is set.
+/// The map, its scale and placement and the integration settings are
+/// shared and set on the master before initialization.
+
+class NDDMagneticField : public G4MagneticField {
+ public:
+  NDDMagneticField(const NDDFieldMap* map, G4double scale,
+                   const G4ThreeVector& offset);
+
+  virtual void GetFieldValue(const G4double point[4], G4double* field) const;
+
+  static inline G4bool IsEnabled() { return fieldMap != nullptr; }
+  static G4bool SetMap(const G4String& filename);
+  static inline void SetScale(G4double s) { scale = s; }
+  static inline void SetOffset(const G4ThreeVector& v) { offset = v; }
+  static inline NDDFieldIntegration& GetIntegration() { return integration; }
+
+  // field, equation, stepper and chord finder of the calling thread, in
+  // its global field manager
+  static void Install();
+
+ private:
+  static const NDDFieldMap* fieldMap;
+  static G4double scale;
+  static G4ThreeVector offset;
+  static NDDFieldIntegration integration;
+
+  NDDFieldMapInterpolator interpolator;
+};
+
+#endif
@@ -0,0 +1,38 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDPassiveSD_h
+#define NDDPassiveSD_h 1
+
+#include "G4VSensitiveDetector.hh"
+
+class G4Step;
+class G4HCofThisEvent;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Energy accounting in a passive volume: the dead layer, the backing and
+/// the source foil, carrier and holder.
+///
+/// The detector sums the energy deposited in its volumes during the event
+/// and the energy of bremsstrahlung photons leaving them into the vacuum.
+/// It keeps no hits; the event action reads the sums at the end of the
+/// event, so the work is only done for steps inside these volumes.
+
+class NDDPassiveSD : public G4VSensitiveDetector {
+ public:
+  NDDPassiveSD(const G4String& name);
+  virtual ~NDDPassiveSD();
+
+  virtual void Initialize(G4HCofThisEvent* hitCollection);
+  virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory* history);
+
+  inline G4double GetEnergyDeposit() const { return eDep; }
+  inline G4double GetBremsstrahlungLoss() const { return bremsstrahlungLoss; }
+
+ private:
+  G4double eDep;
+  G4double bremsstrahlungLoss;
+};
+
+#endif
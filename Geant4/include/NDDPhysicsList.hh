@@ -15,6 +15,7 @@ class NDDPhysicsList : public G4VModularPhysicsList {
   virtual ~NDDPhysicsList();
 
   void ConstructParticle();
+  void ConstructProcess();
 
   void SetCuts();
   void SetCutForGamma(G4double);
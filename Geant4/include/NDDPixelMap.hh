@@ -0,0 +1,108 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDPixelMap_h
+#define NDDPixelMap_h 1
+
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Geometry of the hexagonal pixel array, built once with the readout
+/// world and only read afterwards, so all threads share it.
+///
+/// Pixels are hexagons with flat sides along y, `pitch` across flats, in
+/// `rings` rings around the central one. Pixel p (the copy number of the
+/// readout volume, 1 based) has axial coordinates (q, r): q counts columns
+/// along x, and the centre is at x = q pitch cos(30), y = (r + q / 2) pitch.
+/// Pixels are numbered column by column in x, downwards in y within a
+/// column, as the readout world has always placed them. A dense table over
+/// (q, r) gives the pixel at any grid position, so finding the pixel under
+/// a point, the neighbours or all pixels within some rings are O(1) per
+/// pixel. The map is written to the pixelMap ntuple of the output file.
+///
+/// Every detector has the same array. Detector d (0 based, the copy number
+/// of its readout volume) owns pixels d N + 1 to (d + 1) N, N pixels per
+/// detector, so a pixel number identifies the detector too and everything
+/// indexed by pixel number covers all detectors. Neighbours, distances and
+/// pixels within some rings never cross detectors, and the centres are in
+/// the frame of the detector's own array.
+
+class NDDPixelMap {
+ public:
+  static NDDPixelMap* Instance();
+
+  // one array per detector name, the names ending the pixel names
+  void Build(G4double pitch, G4int rings,
+             const std::vector<G4String>& detectors =
+                 std::vector<G4String>(1, "E"));
+
+  inline G4bool IsBuilt() const { return !centres.empty(); }
+  // of all detectors
+  inline G4int GetNumberOfPixels() const { return centres.size(); }
+  inline G4int GetPixelsPerDetector() const { return pixelsPerDetector; }
+  inline G4int GetNumberOfDetectors() const { return detectors.size(); }
+  inline const G4String& GetDetectorName(G4int detector) const {
+    return detectors[detector];
+  }
+  inline G4int GetDetector(G4int pixel) const {
+    return (pixel - 1) / pixelsPerDetector;
+  }
+  // pixel `local` (1 based) of a detector
+  inline G4int GetPixelNumber(G4int detector, G4int local) const {
+    return detector * pixelsPerDetector + local;
+  }
+  inline G4double GetPitch() const { return pitch; }
+  inline G4int GetRings() const { return rings; }
+
+  // in the frame of the pixel array, z = 0, indexed by pixel - 1
+  inline const std::vector<G4ThreeVector>& GetCentres() const { return centres; }
+  inline const G4ThreeVector& GetCentre(G4int pixel) const {
+    return centres[pixel - 1];
+  }
+  inline G4int GetQ(G4int pixel) const { return q[pixel - 1]; }
+  inline G4int GetR(G4int pixel) const { return r[pixel - 1]; }
+  // the up to six pixels sharing a side
+  inline const std::vector<G4int>& GetNeighbours(G4int pixel) const {
+    return neighbours[pixel - 1];
+  }
+
+  // the neighbour across side k = 0..5 of a pixel, counter-clockwise from
+  // +y, and the unit vector towards it; 0 when there is no pixel there
+  G4int GetNeighbour(G4int pixel, G4int k) const;
+  G4ThreeVector GetDirection(G4int k) const;
+
+  // 0 when there is no pixel there
+  G4int GetPixel(G4int q, G4int r, G4int detector = 0) const;
+  G4int FindPixel(G4double x, G4double y, G4int detector = 0) const;
+
+  // number of steps between two pixels of the same detector on the grid
+  G4int GetDistance(G4int a, G4int b) const;
+  // pixels at most `n` steps from `pixel`, itself included, in order
+  void GetPixelsWithin(G4int pixel, G4int n, std::vector<G4int>& pixels) const;
+  // steps needed to include every pixel whose centre is within `distance`
+  G4int GetStepsWithin(G4double distance) const;
+
+  // column name in the pixelEnergies ntuple
+  G4String GetName(G4int pixel) const;
+
+ private:
+  NDDPixelMap();
+
+  G4double pitch;
+  G4int rings;
+  G4int pixelsPerDetector;
+  std::vector<G4String> detectors;
+  std::vector<G4ThreeVector> centres;
+  std::vector<G4int> q, r;
+  std::vector<std::vector<G4int> > neighbours;
+  // pixel of the first detector at (q + rings) * (2 rings + 1) + r + rings,
+  // 0 for none
+  std::vector<G4int> lookup;
+};
+
+#endif
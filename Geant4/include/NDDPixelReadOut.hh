@@ -3,14 +3,23 @@
 
 #include "G4VUserParallelWorld.hh"
 
+class NDDDetectorConstruction;
+
+/// Readout world with the pixels of every detector of the mass geometry.
+/// The pixel array is one logical volume, placed once per detector with
+/// the detector index as copy number, numbered as in NDDPixelMap.
+
 class NDDPixelReadOut : public G4VUserParallelWorld {
 public:
-  NDDPixelReadOut(G4String&);
+  NDDPixelReadOut(G4String&, const NDDDetectorConstruction*);
   virtual ~NDDPixelReadOut();
 
 protected:
   virtual void Construct();
   virtual void ConstructSD();
+
+private:
+  const NDDDetectorConstruction* detector;
 };
 
 #endif
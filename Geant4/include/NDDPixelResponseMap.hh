@@ -0,0 +1,81 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDPixelResponseMap_h
+#define NDDPixelResponseMap_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <algorithm>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Weighting potential and drift times of one pixel on a regular 3D grid,
+/// in the pixel frame of the readout world (x, y from the pixel centre, z
+/// from the front face of the pixel volume).
+/// Every pixel shares the same map, shifted to its own centre.
+///
+/// The file is plain text, '#' starts a comment, exported from SSD with
+/// SSD/ExportResponseMap.jl:
+///
+///   pixelSide zmin|zmax          side of the pixel electrodes
+///   grid nx ny nz
+///   range xMin xMax yMin yMax zMin zMax      [mm]
+///   W tCollected tOther          nx*ny*nz lines, z fastest, then y, x
+///
+/// W is the weighting potential of the pixel, tCollected the drift time [ns]
+/// of the carrier collected on the pixel side to its electrode and tOther
+/// that of the opposite carrier to the back contact. Carriers drift
+/// straight along z. Maps are loaded once per process and shared read-only
+/// by all threads.
+
+class NDDPixelResponseMap {
+ public:
+  static const NDDPixelResponseMap* Load(const G4String& filename);
+
+  // Bilinear weights of the z column through (x, y); false outside the map
+  struct Column {
+    G4int index[4];
+    G4double weight[4];
+  };
+  G4bool GetColumn(G4double x, G4double y, Column& column) const;
+
+  // value along a column at height z
+  G4double GetW(const Column& c, G4double z) const;
+  G4double GetTime(const Column& c, G4bool collected, G4double z) const;
+  // fills out[iz] = value at each grid plane, the hot loop of the digitizer
+  void GetWColumn(const Column& c, G4double* out) const;
+  void GetTimeColumn(const Column& c, G4bool collected, G4double* out) const;
+
+  inline G4int GetNz() const { return nz; }
+  inline G4double GetZ(G4int iz) const { return zMin + iz * dz; }
+  inline G4double GetZMin() const { return zMin; }
+  inline G4double GetZMax() const { return zMin + (nz - 1) * dz; }
+  inline G4bool IsPixelSideLow() const { return pixelSideLow; }
+  inline G4double GetHalfWidth() const {
+    return std::max(-xMin, xMin + (nx - 1) * dx);
+  }
+
+ private:
+  NDDPixelResponseMap(const G4String&);
+  G4bool Read();
+
+  G4double Interpolate(const std::vector<G4float>& v, const Column& c,
+                       G4double z) const;
+  void FillColumn(const std::vector<G4float>& v, const Column& c,
+                  G4double* out) const;
+
+  G4String filename;
+  G4bool pixelSideLow;
+  G4int nx, ny, nz;
+  G4double xMin, yMin, zMin;
+  G4double dx, dy, dz;
+  // z fastest, so that a column is contiguous
+  std::vector<G4float> potential;
+  std::vector<G4float> timeCollected;
+  std::vector<G4float> timeOther;
+};
+
+#endif
@@ -0,0 +1,52 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDPixelSpectra_h
+#define NDDPixelSpectra_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <map>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Per-pixel energy spectra with lazy, sparse storage.
+///
+/// A pixel's spectrum only exists once the pixel has been filled, and only
+/// non-empty bins are stored, so a collimated beam that lights up a handful
+/// of pixels costs a handful of small maps per thread instead of one dense
+/// histogram per pixel. At the end of a run every thread writes its
+/// non-empty bins as rows of the pixelSpectra ntuple (pixelNumber, name,
+/// bin, energy [keV], counts), in the format of the analysis manager; the
+/// spectrum of a pixel is the sum of its rows over all workers. Unlike
+/// H1s booked on demand, the ntuple is the same on the master and every
+/// worker, and is booked before the output file is opened.
+
+class NDDPixelSpectra {
+ public:
+  // xMin and xMax in internal units, the spectra are binned in `unit`
+  NDDPixelSpectra(G4int nBins, G4double xMin, G4double xMax,
+                  const G4String& unit);
+  ~NDDPixelSpectra();
+
+  void Fill(G4int pixel, G4double value, G4double weight = 1.);
+  void Reset();
+
+  // one row per non-empty bin; bin -1 is underflow, bin nBins overflow
+  void FillNtuple(G4int ntupleID) const;
+
+  inline size_t GetNumberOfFilledPixels() const { return spectra.size(); }
+
+ private:
+  typedef std::map<G4int, G4double> SparseSpectrum;
+
+  G4int nBins;
+  G4double unitValue;
+  // in `unit`
+  G4double xMin, xMax;
+
+  std::map<G4int, SparseSpectrum> spectra;
+};
+
+#endif
@@ -0,0 +1,68 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDPrecisionMonitor_h
+#define NDDPrecisionMonitor_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <atomic>
+#include <vector>
+
+class NDDPrecisionMonitorMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Process-wide counters for /NDD/run/untilPrecision.
+///
+/// Every thread reports its events here; once the chosen observable reaches
+/// the requested relative uncertainty the run is flagged as converged and
+/// each worker aborts its event loop at the next end of event. Configuration
+/// is only changed from the master between runs, the counters are atomic.
+
+class NDDPrecisionMonitor {
+ public:
+  enum Observable { kNone, kSiHitFraction, kBackscatterFraction, kPixelPeak };
+
+  static NDDPrecisionMonitor* Instance();
+
+  // /NDD/run/ commands; created and deleted by the master run action
+  static void CreateMessenger();
+  static void DeleteMessenger();
+
+  void SetTarget(const G4String& observable, G4double relPrecision);
+  inline void SetCheckInterval(G4int n) { checkInterval = n > 0 ? n : 1; }
+  inline void SetMinEvents(G4int n) { minEvents = n; }
+  void SetPeak(G4int pixel, G4double eLow, G4double eHigh);
+
+  inline G4bool IsActive() const { return observable != kNone; }
+  inline G4bool IsConverged() const { return converged.load(); }
+
+  void Reset();
+  void RecordEvent(G4double enDepSi, G4bool backscatter,
+                   const std::vector<G4double>& pixelEnDep);
+
+  G4double GetRelativePrecision() const;
+  void Report() const;
+
+ private:
+  static NDDPrecisionMonitorMessenger* messenger;
+
+  NDDPrecisionMonitor();
+
+  G4String GetObservableName() const;
+
+  Observable observable;
+  G4double target;
+  G4int checkInterval;
+  G4int minEvents;
+  G4int peakPixel;
+  G4double peakLow, peakHigh;
+
+  std::atomic<G4long> nEvents;
+  std::atomic<G4long> nSelected;
+  std::atomic<G4bool> converged;
+};
+
+#endif
@@ -0,0 +1,33 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDPrecisionMonitorMessenger_h
+#define NDDPrecisionMonitorMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAnInteger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// /NDD/run/ commands of the NDDPrecisionMonitor.
+
+class NDDPrecisionMonitorMessenger : public G4UImessenger {
+ public:
+  NDDPrecisionMonitorMessenger();
+  virtual ~NDDPrecisionMonitorMessenger();
+
+  virtual void SetNewValue(G4UIcommand*, G4String);
+
+ private:
+  G4UIdirectory* runDir;
+
+  G4UIcommand* untilPrecisionCmd;
+  G4UIcommand* precisionPeakCmd;
+  G4UIcmdWithAnInteger* precisionIntervalCmd;
+  G4UIcmdWithAnInteger* precisionMinEventsCmd;
+};
+
+#endif
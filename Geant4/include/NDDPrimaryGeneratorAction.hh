@@ -4,9 +4,12 @@
 #define NDDPrimaryGeneratorAction_h 1
 
 #include "G4VUserPrimaryGeneratorAction.hh"
+#include "G4String.hh"
 
 class G4GeneralParticleSource;
 class G4Event;
+class NDDPrimaryGeneratorMessenger;
+class NDDResponseMatrix;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -17,8 +20,18 @@ class NDDPrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction {
 
   virtual void GeneratePrimaries(G4Event*);
 
+  void SetResponseMatrix(const G4String&);
+  void SetSurrogateMode(G4bool);
+  inline G4bool GetSurrogateMode() const { return surrogateMode; }
+
  private:
+  void GenerateSurrogate(G4Event*);
+
   G4GeneralParticleSource* particleGun;
+  NDDPrimaryGeneratorMessenger* genMessenger;
+
+  const NDDResponseMatrix* responseMatrix;
+  G4bool surrogateMode;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
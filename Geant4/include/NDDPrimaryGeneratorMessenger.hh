@@ -0,0 +1,32 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDPrimaryGeneratorMessenger_h
+#define NDDPrimaryGeneratorMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class NDDPrimaryGeneratorAction;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class NDDPrimaryGeneratorMessenger : public G4UImessenger {
+ public:
+  NDDPrimaryGeneratorMessenger(NDDPrimaryGeneratorAction*);
+  virtual ~NDDPrimaryGeneratorMessenger();
+
+  virtual void SetNewValue(G4UIcommand*, G4String);
+
+ private:
+  NDDPrimaryGeneratorAction* fPrimaryGenerator;
+
+  G4UIdirectory* surrogateDir;
+
+  G4UIcmdWithAString* responseMatrixCmd;
+  G4UIcmdWithABool* surrogateEnableCmd;
+};
+
+#endif
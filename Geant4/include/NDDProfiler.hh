@@ -0,0 +1,94 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDProfiler_h
+#define NDDProfiler_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <chrono>
+#include <map>
+#include <utility>
+#include <vector>
+
+class G4Step;
+class G4Track;
+class G4VPhysicalVolume;
+class G4ParticleDefinition;
+class G4VProcess;
+
+class NDDProfilerMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Opt-in CPU profiling of the user actions.
+///
+/// Level 1 counts steps per (volume, particle), process and track type;
+/// level 2 additionally attributes the wall time between consecutive steps
+/// to the volume and process of the later step, and times every event.
+/// Each thread fills its own instance; workers merge into a shared summary
+/// at end of run and the master writes it out as JSON. With the level at 0
+/// the only cost in the stepping action is one static integer compare.
+
+class NDDProfiler {
+ public:
+  enum Level { kOff = 0, kCounters = 1, kTiming = 2 };
+
+  static NDDProfiler* Instance();
+
+  // /NDD/profile/ commands; created and deleted by the master run action
+  static void CreateMessenger();
+  static void DeleteMessenger();
+
+  static inline G4bool IsEnabled() { return level != kOff; }
+  static inline G4int GetLevel() { return level; }
+  static void SetLevel(G4int l) { level = l; }
+  static void SetOutputFile(const G4String& s) { outputFile = s; }
+
+  void BeginEvent(G4int eventID);
+  void EndEvent();
+  void BeginTrack(const G4Track*);
+  void RecordStep(const G4Step*);
+
+  void Reset();
+  void MergeToMaster();
+  static void WriteSummary(const G4String& defaultName);
+
+  inline G4long GetTotalSteps() const { return totalSteps; }
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Counter {
+    G4long steps;
+    G4double seconds;
+  };
+
+  typedef std::pair<const G4VPhysicalVolume*, const G4ParticleDefinition*>
+      StepKey;
+
+  NDDProfiler();
+
+  static NDDProfilerMessenger* messenger;
+  static G4int level;
+  static G4String outputFile;
+
+  std::map<StepKey, Counter> volumeParticle;
+  std::map<const G4VProcess*, Counter> processes;
+  std::map<const G4ParticleDefinition*, G4long> tracks;
+
+  StepKey lastKey;
+  Counter* lastCounter;
+
+  Clock::time_point lastStepTime;
+  Clock::time_point eventStartTime;
+  G4int currentEvent;
+
+  G4long totalSteps;
+  G4long nEvents;
+  G4double eventSum, eventSum2, eventMax;
+  std::vector<std::pair<G4double, G4int> > slowestEvents;
+};
+
+#endif
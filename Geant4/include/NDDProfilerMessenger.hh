@@ -0,0 +1,31 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDProfilerMessenger_h
+#define NDDProfilerMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithAString;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// /NDD/profile/ commands of the NDDProfiler.
+
+class NDDProfilerMessenger : public G4UImessenger {
+ public:
+  NDDProfilerMessenger();
+  virtual ~NDDProfilerMessenger();
+
+  virtual void SetNewValue(G4UIcommand*, G4String);
+
+ private:
+  G4UIdirectory* profileDir;
+
+  G4UIcmdWithAnInteger* profileLevelCmd;
+  G4UIcmdWithAString* profileFileCmd;
+};
+
+#endif
@@ -0,0 +1,64 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDPulseTemplates_h
+#define NDDPulseTemplates_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Library of unit-charge pixel waveforms on a (depth, radius, angle) grid,
+/// for the template mode of NDDDigitizer.
+///
+/// A template is the charge induced on a pixel, per keV deposited, by a
+/// point deposit at time 0 at the given depth and distance from the pixel
+/// centre; neighbours use the same templates at their own distance. The
+/// angle is folded with the hexagonal symmetry of the pixel into 0-30 deg
+/// from the pixel x axis; a single angle bin gives a purely radial library.
+///
+/// The file is plain text, '#' starts a comment, exported from SSD with
+/// SSD/ExportPulseTemplates.jl:
+///
+///   period T                        sample spacing [ns]
+///   grid nDepth nRadius nAngle nSamples
+///   depth zMin zMax                 pixel frame z [mm]
+///   radius rMax                     [mm], from 0
+///   s0 s1 ... s(nSamples-1)         one template per line, angle fastest,
+///                                   then radius, then depth
+///
+/// Beyond its last sample a template holds its last value. Libraries are
+/// loaded once per process and shared read-only by all threads.
+
+class NDDPulseTemplates {
+ public:
+  static const NDDPulseTemplates* Load(const G4String& filename);
+
+  // Interpolation weights of up to eight templates; false out of reach
+  struct Weights {
+    G4int n;
+    const G4float* templ[8];
+    G4double weight[8];
+  };
+  G4bool GetWeights(G4double depth, G4double x, G4double y, Weights& w) const;
+
+  inline G4double GetPeriod() const { return period; }
+  inline G4int GetNumberOfSamples() const { return nSamples; }
+  inline G4double GetMaxRadius() const { return rMax; }
+
+ private:
+  NDDPulseTemplates(const G4String&);
+  G4bool Read();
+
+  G4String filename;
+  G4double period;
+  G4int nDepth, nRadius, nAngle, nSamples;
+  G4double zMin, zMax, rMax;
+  // nSamples contiguous values per template
+  std::vector<G4float> samples;
+};
+
+#endif
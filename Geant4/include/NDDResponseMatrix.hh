@@ -0,0 +1,63 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDResponseMatrix_h
+#define NDDResponseMatrix_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <vector>
+
+/// One sampled detector response for a single primary.
+struct NDDResponseSample {
+  G4double enDepSi;
+  G4int pixelNumber;
+  G4bool backscatter;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Tabulated Si response as a function of primary energy.
+///
+/// The file is plain text, one outcome per line, '#' starts a comment:
+///
+///   eLow eHigh enSiLow enSiHigh pixel backscatter weight
+///
+/// Energies are in keV. All lines sharing the same [eLow, eHigh) primary
+/// energy bin form one discrete distribution; the deposited energy is drawn
+/// uniformly inside [enSiLow, enSiHigh). A pixel number of 0 (or a zero
+/// deposit) denotes a primary that left nothing in the Si.
+///
+/// Matrices are loaded once per process and shared read-only by all threads.
+
+class NDDResponseMatrix {
+ public:
+  static const NDDResponseMatrix* Load(const G4String& filename);
+
+  NDDResponseSample Sample(G4double primaryEnergy) const;
+
+  inline const G4String& GetFilename() const { return filename; }
+  inline size_t GetNumberOfBins() const { return bins.size(); }
+
+ private:
+  struct Outcome {
+    G4double enSiLow, enSiHigh;
+    G4int pixelNumber;
+    G4bool backscatter;
+  };
+
+  struct EnergyBin {
+    G4double eLow, eHigh;
+    std::vector<Outcome> outcomes;
+    std::vector<G4double> cumulative;
+  };
+
+  NDDResponseMatrix(const G4String&);
+  G4bool Read();
+
+  G4String filename;
+  std::vector<EnergyBin> bins;
+};
+
+#endif
@@ -7,7 +7,10 @@
 #include "G4UserRunAction.hh"
 #include "G4String.hh"
 
+#include "NDDAnalysis.hh"
+
 class NDDRunMessenger;
+class NDDPixelSpectra;
 class G4Run;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -18,6 +21,8 @@ class NDDRunAction : public G4UserRunAction {
   virtual ~NDDRunAction();
 
  public:
+  enum HitsColumnSet { kHitsFull, kHitsNoMomentum, kHitsMinimal };
+
   virtual void BeginOfRunAction(const G4Run*);
   virtual void EndOfRunAction(const G4Run*);
 
@@ -27,10 +32,49 @@ class NDDRunAction : public G4UserRunAction {
   inline void SetFilename(const G4String& s) { filename = s;}
   inline const G4String& GetFilename() const { return filename; }
 
+  inline NDDPixelSpectra* GetPixelSpectra() const { return pixelSpectra; }
+
+  // Output selection, see /NDD/output/
+  void SetNtupleEnabled(const G4String& name, G4bool enable);
+  void SetHistogramsEnabled(const G4String& group, G4bool enable);
+  void SetHitsColumnSet(const G4String& set);
+  void SetHitsPrecision(const G4String& precision);
+  void SetHitsLayout(const G4String& layout);
+
+  G4bool IsNtupleEnabled(G4int id) const;
+  inline G4bool GeneralHistogramsEnabled() const { return generalHistograms; }
+  inline G4bool PixelHistogramsEnabled() const { return pixelHistograms; }
+  inline G4bool Histograms2DEnabled() const { return histograms2D; }
+
+  inline const NDDHitsColumns& GetHitsColumns() const { return hitsColumns; }
+  inline NDDEventHits& GetEventHits() { return eventHits; }
+  inline G4int GetNumberOfPixelColumns() const { return nPixelColumns; }
+  inline std::vector<G4double>& GetWaveformSamples() { return waveformSamples; }
+
  private:
+  void BookNtuples();
+  void BookHitsNtuple();
+  void ApplyActivation();
+  void FillPixelMapNtuple();
+
   NDDRunMessenger* runMessenger;
   G4int fSaveRndm;
   G4String filename;
+  NDDPixelSpectra* pixelSpectra;
+
+  G4int nrH1, nrH2;
+  G4int filterH1;
+  G4bool ntuplesBooked;
+  G4bool ntupleEnabled[kNumberOfNtuples];
+  G4bool generalHistograms, pixelHistograms, histograms2D;
+  HitsColumnSet hitsColumnSet;
+  NDDHitsPrecision hitsPrecision;
+  G4bool hitsPerEvent;
+  NDDHitsColumns hitsColumns;
+  NDDEventHits eventHits;
+  G4int nPixelColumns;
+  std::vector<G4double> waveformSamples;
+  std::vector<G4int> pixelMapNeighbours;
 };
 
 #endif
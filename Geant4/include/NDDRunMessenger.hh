@@ -10,6 +10,7 @@ class NDDRunAction;
 class G4UIdirectory;
 class G4UIcmdWithAnInteger;
 class G4UIcmdWithAString;
+class G4UIcommand;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -27,6 +28,15 @@ class NDDRunMessenger : public G4UImessenger {
 
   G4UIcmdWithAnInteger* randomSaveCmd;
   G4UIcmdWithAString* randomReadCmd;
+
+  G4UIdirectory* outputDir;
+
+  G4UIcmdWithAString* filenameCmd;
+  G4UIcommand* ntupleCmd;
+  G4UIcommand* histogramsCmd;
+  G4UIcmdWithAString* hitsColumnsCmd;
+  G4UIcmdWithAString* hitsPrecisionCmd;
+  G4UIcmdWithAString* hitsLayoutCmd;
 };
 
 #endif
@@ -31,33 +31,39 @@ class NDDSiPixelHit : public G4VHit {
   void SetTrackID(G4int track) { trackID = track; };
   void SetEnDep(G4double de) { enDep = de; };
   void SetPos(G4ThreeVector xyz) { pos = xyz; };
+  void SetLocalPos(G4ThreeVector xyz) { localPos = xyz; };
   void SetTime(G4double t) { time = t; };
   void SetMomentum(G4ThreeVector mom) { momentum = mom; };
   void SetField(G4ThreeVector f) { field = f; };
   void SetParticleCode(G4int pc) { particleCode = pc; };
   void SetPixelNumber(G4int pn) { pixelNumber= pn; };
+  void SetDetector(G4int d) { detector = d; };
   void SetPixelName(G4String pn) { pixelName = pn; };
 
   // Get methods
   G4int GetTrackID() const { return trackID; };
   G4double GetEnDep() const { return enDep; };
   G4ThreeVector GetPos() const { return pos; };
+  G4ThreeVector GetLocalPos() const { return localPos; };
   G4double GetTime() const { return time; };
   G4ThreeVector GetMomentum() const { return momentum; };
   G4ThreeVector GetField() const { return field; };
   G4int GetParticleCode() const { return particleCode; };
   G4int GetPixelNumber() const { return pixelNumber; };
+  G4int GetDetector() const { return detector; };
   G4String GetPixelName() const { return pixelName; };
 
  private:
   G4int trackID;
   G4double enDep;
   G4ThreeVector pos;
+  G4ThreeVector localPos;  // in the frame of the readout pixel
   G4ThreeVector momentum;
   G4ThreeVector field;
   G4double time;
   G4int particleCode;
-  G4int pixelNumber;
+  G4int pixelNumber;  // over all detectors, see NDDPixelMap
+  G4int detector;     // index in /NDD/geometry/addDetector order
   G4String pixelName;
 };
 
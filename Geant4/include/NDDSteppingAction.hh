@@ -5,6 +5,7 @@
 #include "globals.hh"
 
 class NDDEventAction;
+class NDDProfiler;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -17,6 +18,7 @@ class NDDSteppingAction : public G4UserSteppingAction {
 
  private:
   NDDEventAction* eventAction;
+  NDDProfiler* profiler;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,39 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDSurrogateEventInformation_h
+#define NDDSurrogateEventInformation_h 1
+
+#include "NDDResponseMatrix.hh"
+
+#include "G4VUserEventInformation.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Attached to events generated in surrogate mode. The event carries no
+/// primary vertex, so this is the only record of what was sampled.
+
+class NDDSurrogateEventInformation : public G4VUserEventInformation {
+ public:
+  NDDSurrogateEventInformation(G4double e, const NDDResponseSample& s)
+      : G4VUserEventInformation(), primaryEnergy(e), sample(s) {}
+  virtual ~NDDSurrogateEventInformation() {}
+
+  virtual void Print() const {
+    G4cout << "Surrogate event: primary " << primaryEnergy / keV
+           << " keV, Si " << sample.enDepSi / keV << " keV in pixel "
+           << sample.pixelNumber << (sample.backscatter ? " (backscatter)" : "")
+           << G4endl;
+  }
+
+  inline G4double GetPrimaryEnergy() const { return primaryEnergy; }
+  inline const NDDResponseSample& GetSample() const { return sample; }
+
+ private:
+  G4double primaryEnergy;
+  NDDResponseSample sample;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef NDDTrackingAction_h
+#define NDDTrackingAction_h 1
+
+#include "G4UserTrackingAction.hh"
+#include "globals.hh"
+
+class NDDProfiler;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class NDDTrackingAction : public G4UserTrackingAction {
+ public:
+  NDDTrackingAction();
+  ~NDDTrackingAction();
+
+  void PreUserTrackingAction(const G4Track*);
+
+ private:
+  NDDProfiler* profiler;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
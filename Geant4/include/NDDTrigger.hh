@@ -0,0 +1,87 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDTrigger_h
+#define NDDTrigger_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "NDDSiPixelHit.hh"
+#include "NDDChargeSharing.hh"
+#include "NDDDigitizer.hh"
+
+#include <vector>
+
+class NDDTriggerMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+struct NDDTriggerRecord {
+  G4int pixelNumber;
+  G4double energy;  // with noise
+  G4double time;
+  G4bool selfTriggered;  // false when only read out as a neighbour
+};
+
+/// What the DAQ would record of an event (/NDD/trigger/).
+///
+/// Every pixel has a threshold and a Gaussian noise, by default the same
+/// for all and optionally per pixel from a file. The event triggers when
+/// the first pixel crosses its threshold; pixels above threshold within the
+/// trigger window after that are recorded, together with their neighbours
+/// in the NDDPixelMap if neighbour readout is on.
+///
+/// Pixel energies come from the digitized waveform amplitudes when the
+/// digitizer runs, otherwise from the hits, or their shared deposits with
+/// /NDD/sharing/, summed in time order so the trigger time is where the
+/// cumulative energy crosses the threshold.
+/// Each worker owns one instance; the settings are shared and set on the
+/// master.
+
+class NDDTrigger {
+ public:
+  NDDTrigger();
+
+  // /NDD/trigger/ commands; created and deleted by the master run action
+  static void CreateMessenger();
+  static void DeleteMessenger();
+
+  static inline G4bool IsEnabled() { return threshold > 0 || !thresholds.empty(); }
+  static inline void SetThreshold(G4double e) { threshold = e; }
+  static inline void SetNoise(G4double e) { noise = e; }
+  static inline void SetWindow(G4double t) { window = t; }
+  static inline void SetNeighbourReadout(G4bool b) { neighbourReadout = b; }
+  // lines of "pixel threshold [noise]" in keV, 'none' to clear
+  static G4bool LoadThresholds(const G4String& filename);
+
+  // shared deposits and waveforms are used instead of the hits if given
+  const std::vector<NDDTriggerRecord>& Process(
+      NDDSiPixelHitsCollection* hc, const std::vector<NDDPixelDeposit>* shared,
+      const std::vector<NDDPixelWaveform>* waveforms, G4double startTime);
+
+ private:
+  G4double GetThreshold(G4int pixel) const;
+  G4double GetNoise(G4int pixel) const;
+  G4double FromDeposits();
+  G4double FromWaveforms(const std::vector<NDDPixelWaveform>& waveforms,
+                         G4double startTime);
+  void Record(G4double triggerTime);
+
+  static NDDTriggerMessenger* messenger;
+  static G4double threshold;
+  static G4double noise;
+  static G4double window;
+  static G4bool neighbourReadout;
+  static std::vector<G4double> thresholds;
+  static std::vector<G4double> noises;
+
+  // per pixel, index pixelNumber - 1, reused between events
+  std::vector<G4double> noiseSample;
+  std::vector<G4double> energy;
+  std::vector<G4double> time;  // threshold crossing, or first signal
+  std::vector<G4bool> recorded;
+  std::vector<NDDPixelDeposit> sorted;
+  std::vector<NDDTriggerRecord> records;
+};
+
+#endif
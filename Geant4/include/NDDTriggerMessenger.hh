@@ -0,0 +1,35 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDTriggerMessenger_h
+#define NDDTriggerMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithABool;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// /NDD/trigger/ commands of the NDDTrigger.
+
+class NDDTriggerMessenger : public G4UImessenger {
+ public:
+  NDDTriggerMessenger();
+  virtual ~NDDTriggerMessenger();
+
+  virtual void SetNewValue(G4UIcommand*, G4String);
+
+ private:
+  G4UIdirectory* triggerDir;
+
+  G4UIcmdWithADoubleAndUnit* triggerThresholdCmd;
+  G4UIcmdWithAString* triggerThresholdsCmd;
+  G4UIcmdWithADoubleAndUnit* triggerNoiseCmd;
+  G4UIcmdWithADoubleAndUnit* triggerWindowCmd;
+  G4UIcmdWithABool* triggerNeighboursCmd;
+};
+
+#endif
@@ -0,0 +1,82 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDUserLimits_h
+#define NDDUserLimits_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4UserLimits.hh"
+
+#include <map>
+#include <vector>
+
+class G4ParticleDefinition;
+class G4Step;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Track killing conditions per logical volume (/NDD/limits/): a maximum
+/// global time, a minimum kinetic energy per particle type and a maximum
+/// distance from the detectors: a track is killed once it is beyond it from
+/// every detector and moving away from each of them.
+///
+/// Every logical volume gets its own limits in SetStepLimits, falling back
+/// to the global ones ("all") for what it does not set, so that commands
+/// given after initialization still apply. The time and energy limits are
+/// enforced by G4UserSpecialCuts, which deposits the remaining kinetic
+/// energy where the track stops; the physics list only attaches it when
+/// one of them is set before /run/initialize. The distance is
+/// checked in the stepping action, which also counts every kill for the
+/// summary at the end of the run. The limits are only changed from the
+/// master between runs; every thread counts its kills in accumulables,
+/// which the run action merges into the master's.
+
+class NDDUserLimits : public G4UserLimits {
+ public:
+  enum Reason { kTime = 0, kEnergy, kDistance, kNumberOfReasons };
+
+  // the limits of a logical volume, "all" for the global ones
+  static NDDUserLimits* Get(const G4String& volume);
+
+  virtual G4double GetUserMaxTime(const G4Track& track);
+  virtual G4double GetUserMinEkin(const G4Track& track);
+  G4double GetMaxDistance() const;
+
+  void SetMaxTime(G4double t);
+  // particle "all" for every particle without a value of its own
+  G4bool SetMinEkin(const G4String& particle, G4double e);
+  void SetMaxDistance(G4double d);
+
+  static inline void ClearDetectorPositions() { detectors.clear(); }
+  static inline void AddDetectorPosition(const G4ThreeVector& v) {
+    detectors.push_back(v);
+  }
+  static inline G4bool IsTimeOrEnergyLimited() { return timeOrEnergyLimited; }
+  static inline G4bool IsDistanceLimited() { return distanceLimited; }
+
+  // kills of the step, if any, with the distance limit applied
+  static void CheckStep(const G4Step* step);
+
+  // the kill counters of the calling thread, created by its run action
+  static void CreateAccumulables();
+  // on the master, once the workers' counters are merged
+  static void Report();
+
+ private:
+  NDDUserLimits(const G4String& volume, NDDUserLimits* global);
+
+  static void Record(Reason reason, const G4Track* track, G4double energy);
+
+  NDDUserLimits* global;
+  // negative when falling back to the global value
+  G4double maxTime;
+  G4double maxDistance;
+  G4double minEkinAll;
+  std::map<const G4ParticleDefinition*, G4double> minEkin;
+
+  static std::vector<G4ThreeVector> detectors;
+  static G4bool timeOrEnergyLimited;
+  static G4bool distanceLimited;
+};
+
+#endif
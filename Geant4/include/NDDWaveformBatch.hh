@@ -0,0 +1,82 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NDDWaveformBatch_h
+#define NDDWaveformBatch_h 1
+
+#include "G4Types.hh"
+
+#include <cstddef>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Pulse shaping chain, see NDDWaveformBatch::Shape
+struct NDDShaping {
+  enum Type { kNone, kCRRC, kTrapezoid };
+  Type type;
+  G4double tau;    // CR-RC^n time constant
+  G4int order;     // number of RC integrators
+  G4double rise;   // trapezoid rise time
+  G4double flat;   // trapezoid flat top
+  G4double decay;  // preamplifier decay to pole-zero correct, 0 for none
+};
+
+struct NDDPulseFeatures {
+  G4double amplitude;
+  G4double time;      // crossing of the low fraction, from the first sample
+  G4double peakTime;  // from the first sample
+  G4double riseTime;  // between the low and high fractions
+};
+
+/// Many waveforms of equal length and sampling, processed together.
+///
+/// Samples are stored interleaved, all waveforms of sample 0 first, then
+/// sample 1 and so on. The filters are recursive in time, so they cannot be
+/// vectorized along a waveform; with this layout every time step is one
+/// contiguous loop over the waveforms instead, which the compiler
+/// vectorizes. The same kernels serve the digitizer and the standalone
+/// NDDShapeWaveforms tool, and follow SSD/DigitalFilters.jl and
+/// SSD/WaveformAnalysis.jl.
+
+class NDDWaveformBatch {
+ public:
+  NDDWaveformBatch();
+
+  void Resize(G4int nWaveforms, G4int nSamples, G4double period);
+  // shorter waveforms hold their last sample
+  void SetWaveform(G4int w, const G4double* samples, G4int n);
+  void GetWaveform(G4int w, G4double* samples) const;
+
+  inline G4int GetNumberOfWaveforms() const { return nWaveforms; }
+  inline G4int GetNumberOfSamples() const { return nSamples; }
+  inline G4double GetPeriod() const { return period; }
+
+  // single stage filters, in place
+  void LowPass(G4double rc);
+  void HighPass(G4double rc);
+  void Integrate();
+  void PoleZero(G4double decay);
+  void Trapezoid(G4double rise, G4double flat);
+
+  // a full chain, normalized to unit gain for a step
+  void Shape(const NDDShaping& shaping);
+
+  // amplitude, timing and rise time between two fractions of the amplitude
+  void Extract(G4double low, G4double high,
+               std::vector<NDDPulseFeatures>& features);
+
+ private:
+  inline G4double* Sample(G4int s) { return &data[(size_t)s * nWaveforms]; }
+
+  G4int nWaveforms, nSamples;
+  G4double period;
+  std::vector<G4double> data;
+
+  // per waveform state of the recursions, reused
+  std::vector<G4double> state, previous;
+  std::vector<G4double> copy;
+  std::vector<G4double> amplitude, peak, tLow, tHigh;
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include "NDDRunAction.hh"
 #include "NDDEventAction.hh"
 #include "NDDSteppingAction.hh"
+#include "NDDTrackingAction.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -23,8 +24,10 @@ void NDDActionInitialization::BuildForMaster() const {
 void NDDActionInitialization::Build() const {
   SetUserAction(new NDDPrimaryGeneratorAction);
 
-  SetUserAction(new NDDRunAction);
-  NDDEventAction* eventAction = new NDDEventAction;
+  NDDRunAction* runAction = new NDDRunAction;
+  SetUserAction(runAction);
+  NDDEventAction* eventAction = new NDDEventAction(runAction);
   SetUserAction(eventAction);
+  SetUserAction(new NDDTrackingAction);
   SetUserAction(new NDDSteppingAction(eventAction));
 }
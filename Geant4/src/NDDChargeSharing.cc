@@ -0,0 +1,104 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDChargeSharing.hh"
+#include "NDDChargeSharingMessenger.hh"
+#include "NDDPixelMap.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+
+G4double NDDChargeSharing::width = 0.;
+G4double NDDChargeSharing::initialWidth = 0.;
+G4double NDDChargeSharing::thickness = 2. * mm;
+NDDChargeSharingMessenger* NDDChargeSharing::messenger = nullptr;
+
+namespace {
+// tails beyond this many sigma are dropped
+const G4double tailRange = 5.;
+const G4int tailBins = 500;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDChargeSharing::CreateMessenger() {
+  if (!messenger) messenger = new NDDChargeSharingMessenger();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDChargeSharing::DeleteMessenger() {
+  delete messenger;
+  messenger = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDChargeSharing::NDDChargeSharing() {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NDDChargeSharing::Tail(G4double u) {
+  static const std::vector<G4double> table = [] {
+    std::vector<G4double> t(tailBins + 2);
+    for (G4int i = 0; i <= tailBins + 1; i++) {
+      t[i] = 0.5 * std::erfc(i * tailRange / tailBins / std::sqrt(2.));
+    }
+    return t;
+  }();
+
+  if (u < 0) return 1. - Tail(-u);
+  if (u >= tailRange) return 0.;
+  G4double x = u * tailBins / tailRange;
+  G4int i = (G4int)x;
+  return table[i] + (x - i) * (table[i + 1] - table[i]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::vector<NDDPixelDeposit>& NDDChargeSharing::Share(
+    NDDSiPixelHitsCollection* hc) {
+  deposits.clear();
+  for (size_t i = 0; i < hc->entries(); i++) ShareHit((*hc)[i]);
+  return deposits;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDChargeSharing::ShareHit(const NDDSiPixelHit* hit) {
+  G4int pixel = hit->GetPixelNumber();
+  G4double eDep = hit->GetEnDep();
+  G4double time = hit->GetTime();
+  const NDDPixelMap* pixelMap = NDDPixelMap::Instance();
+  if (pixel < 1 || pixel > pixelMap->GetNumberOfPixels() || eDep <= 0) {
+    deposits.push_back({pixel, eDep, time});
+    return;
+  }
+
+  // the local frame is centred on the pixel, the pixel side at thickness
+  G4ThreeVector local = hit->GetLocalPos();
+  G4double drift = std::min(std::max(thickness - local.z(), 0.), thickness);
+  G4double sigma = std::sqrt(initialWidth * initialWidth +
+                             width * width * drift / thickness);
+  G4double halfPitch = pixelMap->GetPitch() / 2.;
+  if (sigma <= 0 || local.perp() < halfPitch - tailRange * sigma) {
+    deposits.push_back({pixel, eDep, time});
+    return;
+  }
+
+  G4double kept = 1.;
+  for (G4int k = 0; k < 6; k++) {
+    G4ThreeVector u = pixelMap->GetDirection(k);
+    G4double edge = halfPitch - local.x() * u.x() - local.y() * u.y();
+    G4double fraction = Tail(edge / sigma);
+    if (fraction <= 0) continue;
+    kept -= fraction;
+    G4int neighbour = pixelMap->GetNeighbour(pixel, k);
+    if (neighbour > 0) deposits.push_back({neighbour, fraction * eDep, time});
+  }
+  deposits.push_back({pixel, std::max(kept, 0.) * eDep, time});
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
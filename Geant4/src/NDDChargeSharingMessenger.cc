@@ -0,0 +1,80 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDChargeSharingMessenger.hh"
+#include "NDDChargeSharing.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDChargeSharingMessenger::NDDChargeSharingMessenger()
+    : G4UImessenger(),
+      sharingDir(0),
+      sharingWidthCmd(0),
+      sharingInitialWidthCmd(0),
+      sharingThicknessCmd(0) {
+  sharingDir = new G4UIdirectory("/NDD/sharing/");
+  sharingDir->SetGuidance("Charge sharing between pixels, see NDDChargeSharing.");
+  sharingDir->SetGuidance("Applies to the pixel energies, spectra and trigger.");
+
+  sharingWidthCmd = new G4UIcmdWithADoubleAndUnit("/NDD/sharing/width", this);
+  sharingWidthCmd->SetGuidance(
+      "Lateral sigma of a charge cloud drifting through the full thickness.");
+  sharingWidthCmd->SetGuidance("0, with no initial width, disables sharing.");
+  sharingWidthCmd->SetParameterName("width", false);
+  sharingWidthCmd->SetRange("width>=0.");
+  sharingWidthCmd->SetUnitCategory("Length");
+  sharingWidthCmd->SetDefaultUnit("um");
+  sharingWidthCmd->SetToBeBroadcasted(false);
+  sharingWidthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  sharingInitialWidthCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/sharing/initialWidth", this);
+  sharingInitialWidthCmd->SetGuidance(
+      "Lateral sigma of the charge cloud before it drifts.");
+  sharingInitialWidthCmd->SetParameterName("width", false);
+  sharingInitialWidthCmd->SetRange("width>=0.");
+  sharingInitialWidthCmd->SetUnitCategory("Length");
+  sharingInitialWidthCmd->SetDefaultUnit("um");
+  sharingInitialWidthCmd->SetToBeBroadcasted(false);
+  sharingInitialWidthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  sharingThicknessCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/sharing/thickness", this);
+  sharingThicknessCmd->SetGuidance("Drift length from the front to the pixels.");
+  sharingThicknessCmd->SetParameterName("thickness", false);
+  sharingThicknessCmd->SetRange("thickness>0.");
+  sharingThicknessCmd->SetUnitCategory("Length");
+  sharingThicknessCmd->SetDefaultUnit("mm");
+  sharingThicknessCmd->SetToBeBroadcasted(false);
+  sharingThicknessCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDChargeSharingMessenger::~NDDChargeSharingMessenger() {
+  delete sharingWidthCmd;
+  delete sharingInitialWidthCmd;
+  delete sharingThicknessCmd;
+  delete sharingDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDChargeSharingMessenger::SetNewValue(G4UIcommand* command,
+                                            G4String newValues) {
+  if (command == sharingWidthCmd)
+    NDDChargeSharing::SetWidth(sharingWidthCmd->GetNewDoubleValue(newValues));
+
+  if (command == sharingInitialWidthCmd)
+    NDDChargeSharing::SetInitialWidth(
+        sharingInitialWidthCmd->GetNewDoubleValue(newValues));
+
+  if (command == sharingThicknessCmd)
+    NDDChargeSharing::SetThickness(
+        sharingThicknessCmd->GetNewDoubleValue(newValues));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -1,5 +1,10 @@
 #include "NDDDetectorConstruction.hh"
 #include "NDDDetectorMessenger.hh"
+#include "NDDElectricField.hh"
+#include "NDDGuidingCentreModel.hh"
+#include "NDDMagneticField.hh"
+#include "NDDPassiveSD.hh"
+#include "NDDUserLimits.hh"
 
 #include "G4VisAttributes.hh"
 #include "G4Colour.hh"
@@ -12,6 +17,8 @@
 #include "G4ThreeVector.hh"
 #include "G4Transform3D.hh"
 
+#include "G4LogicalVolumeStore.hh"
+#include "G4SDManager.hh"
 #include "G4UserLimits.hh"
 #include "G4SystemOfUnits.hh"
 
@@ -23,21 +30,33 @@ NDDDetectorConstruction::NDDDetectorConstruction()
       siBackingThickness(3. * mm),
       siOuterRadius(7.5 * cm),
       deadLayerThickness(100. * nm),
+      stepSize(1.),
       pixelRings(2),
       stepLimitMyl(0),
       stepLimitDead(0),
       stepLimitCar(0) {
   detMess = new NDDDetectorMessenger(this);
-  detectorPosition = G4ThreeVector(0, 0, 10 * mm);
+  detectors.push_back({"E", G4ThreeVector(0, 0, 10 * mm), 1});
+  defaultDetector = true;
 }
 
 NDDDetectorConstruction::~NDDDetectorConstruction() {
   delete stepLimitMyl;
-  delete stepLimitDead;
   delete stepLimitCar;
   delete detMess;
 }
 
+void NDDDetectorConstruction::AddDetector(const G4String& name) {
+  if (defaultDetector) detectors.clear();
+  defaultDetector = false;
+  detectors.push_back({name, G4ThreeVector(0, 0, 10 * mm), 1});
+}
+
+void NDDDetectorConstruction::SetDetectorPosition(G4ThreeVector v) {
+  detectors.back().face = v;
+  detectors.back().side = v.z() >= 0 ? 1 : -1;
+}
+
 G4VPhysicalVolume* NDDDetectorConstruction::Construct() {
 
   BuildMaterials();
@@ -179,50 +198,62 @@ void NDDDetectorConstruction::BuildWorld() {
 }
 
 void NDDDetectorConstruction::BuildSiDetector() {
-  G4double xDead = detectorPosition.x();
-  G4double yDead = detectorPosition.y();
-  G4double zDead = detectorPosition.z() + deadLayerThickness / 2.0;
+  // the logical volumes are shared, every detector places them once with
+  // its index as copy number
+  NDDElectricField::ClearDetectorFaces();
+  NDDUserLimits::ClearDetectorPositions();
 
   solidDead = new G4Tubs("solidDead", 0., siOuterRadius,
                          deadLayerThickness / 2., 0., 360. * deg);
   logicalDead = new G4LogicalVolume(solidDead, siliconMaterial, "Dead");
-  physicalDead = new G4PVPlacement(
-      0, G4ThreeVector(xDead, yDead, zDead), logicalDead,
-      "Dead", logicalWorld, false, 0);
 
   G4double rotationAngleWest = 216 * deg;
   G4double rotationAngle = -257.5 * deg;
 
-  G4RotationMatrix* rot = new G4RotationMatrix(rotationAngle, 0., 0.);
   G4RotationMatrix* rotWest = new G4RotationMatrix(rotationAngleWest, 0., 0.);
 
   // Simple model for Silicon active region
-  G4double xSilicon = detectorPosition.x();
-  G4double ySilicon = detectorPosition.y();
-  G4double zSilicon = detectorPosition.z() +
-                          deadLayerThickness + siThickness / 2.0;
-  // G4cout << "!!!!!!!!!!!!!!!!!!!!!" << " " << zSilicon << G4endl;
-
   solidSilicon = new G4Tubs("solidSilicon", 0., siOuterRadius,
                                 siThickness / 2., 0., 360. * deg);
   logicalSilicon = new G4LogicalVolume(solidSilicon, siliconMaterial,
                                            "logicalSilicon");
-  physicalSilicon = new G4PVPlacement(
-      rot,
-      G4ThreeVector(xSilicon, ySilicon, zSilicon),
-      logicalSilicon, "physicalSilicon", logicalWorld, false, 0);
 
   // Alumina backing (?)
-  G4double zBack =
-      zSilicon + siThickness / 2. + siBackingThickness / 2.;
-
   solidBacking = new G4Tubs("Backing", 0., siOuterRadius,
                             siBackingThickness / 2., 0., 360. * deg);
   logicalBacking =
       new G4LogicalVolume(solidBacking, aluminaMaterial, "Backing");
-  physicalBacking = new G4PVPlacement(
-      0, G4ThreeVector(xSilicon, ySilicon, zBack),
-      logicalBacking, "Backing", logicalWorld, false, 0);
+
+  for (G4int d = 0; d < (G4int)detectors.size(); d++) {
+    const G4ThreeVector& face = detectors[d].face;
+    G4int side = detectors[d].side;
+    NDDElectricField::AddDetectorFace(face, side);
+    NDDUserLimits::AddDetectorPosition(face);
+
+    // detectors looking towards +z are turned over
+    G4RotationMatrix* flip = nullptr;
+    G4RotationMatrix* rot = new G4RotationMatrix(rotationAngle, 0., 0.);
+    if (side < 0) {
+      flip = new G4RotationMatrix();
+      flip->rotateX(180. * deg);
+      rot->rotateX(180. * deg);
+    }
+
+    G4double zDead = deadLayerThickness / 2.0;
+    physicalDead = new G4PVPlacement(
+        flip, face + G4ThreeVector(0., 0., side * zDead), logicalDead,
+        "Dead", logicalWorld, false, d);
+
+    G4double zSilicon = deadLayerThickness + siThickness / 2.0;
+    physicalSilicon = new G4PVPlacement(
+        rot, face + G4ThreeVector(0., 0., side * zSilicon),
+        logicalSilicon, "physicalSilicon", logicalWorld, false, d);
+
+    G4double zBack = zSilicon + siThickness / 2. + siBackingThickness / 2.;
+    physicalBacking = new G4PVPlacement(
+        flip, face + G4ThreeVector(0., 0., side * zBack),
+        logicalBacking, "Backing", logicalWorld, false, d);
+  }
 }
 
 void NDDDetectorConstruction::BuildSources() {
@@ -402,12 +433,41 @@ void NDDDetectorConstruction::BuildVisualisation() {
   logicalDead->SetVisAttributes(simpleBoxVisAttRed);
 }
 
-void NDDDetectorConstruction::ConstructSDandField() {}
+void NDDDetectorConstruction::ConstructSDandField() {
+  // called on every worker, each gets its own field and chord finder
+  NDDMagneticField::Install();
+  NDDGuidingCentreModel::Install();
+
+  // energy accounting in the passive volumes, read by the event action
+  G4SDManager* sdManager = G4SDManager::GetSDMpointer();
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  const char* passiveVolumes[] = {"Dead", "Backing", "Foil", "Carrier",
+                                  "SourceHolder"};
+  for (const char* name : passiveVolumes) {
+    G4String sdName = G4String("/NDD/") + name;
+    G4VSensitiveDetector* sd = sdManager->FindSensitiveDetector(sdName, false);
+    if (!sd) {
+      sd = new NDDPassiveSD(sdName);
+      sdManager->AddNewDetector(sd);
+    }
+    for (G4LogicalVolume* volume : *store) {
+      if (volume->GetName() == name) SetSensitiveDetector(volume, sd);
+    }
+  }
+}
 
 void NDDDetectorConstruction::SetStepLimits() {
+  // every volume gets its kill conditions of /NDD/limits/, which fall back
+  // to the global ones
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  for (G4LogicalVolume* volume : *store) {
+    volume->SetUserLimits(NDDUserLimits::Get(volume->GetName()));
+  }
+
+  // not enforced: the physics list registers no G4StepLimiter
   G4double maxStepDL = stepSize * deadLayerThickness;
-  stepLimitDead = new G4UserLimits(maxStepDL);
-  logicalDead->SetUserLimits(stepLimitDead);
+  stepLimitDead = NDDUserLimits::Get("Dead");
+  stepLimitDead->SetMaxAllowedStep(maxStepDL);
 
   /*G4double maxStepWL = stepSize * waterThickness;
   G4UserLimits* stepLimitWater = new G4UserLimits(maxStepWL);
@@ -1,14 +1,25 @@
 #include "NDDDetectorMessenger.hh"
 #include "NDDDetectorConstruction.hh"
+#include "NDDElectricField.hh"
+#include "NDDGuidingCentreModel.hh"
+#include "NDDMagneticField.hh"
+#include "NDDUserLimits.hh"
 
+#include "G4StateManager.hh"
+#include "G4UIcommand.hh"
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWith3VectorAndUnit.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
 #include "globals.hh"
 
+#include <sstream>
+
 NDDDetectorMessenger::NDDDetectorMessenger(NDDDetectorConstruction* myDet)
-    : detector(myDet) {
+    : detector(myDet), limitsVolume("all") {
   geomDir = new G4UIdirectory("/NDD/geometry/");
   geomDir->SetGuidance("Commands related to the detector geometry");
 
@@ -25,23 +36,320 @@ NDDDetectorMessenger::NDDDetectorMessenger(NDDDetectorConstruction* myDet)
       "carrier volume.");
   sourcePosCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 
+  addDetectorCmd = new G4UIcmdWithAString("/NDD/geometry/addDetector", this);
+  addDetectorCmd->SetGuidance(
+      "Add a detector, named by the suffix of its pixel names (E, W). The "
+      "first replaces the default detector E.");
+  addDetectorCmd->SetParameterName("name", false);
+  addDetectorCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
   detPosCmd =
       new G4UIcmdWith3VectorAndUnit("/NDD/geometry/detectorPosition", this);
   detPosCmd->SetGuidance(
-      "Set the detector position of the last given ID.");
+      "Set the face position of the last added detector. It looks towards "
+      "-z at positive z and towards +z at negative z.");
   detPosCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 
   pixelRingsCmd = new G4UIcmdWithAnInteger("/NDD/geometry/pixelRings", this);
   pixelRingsCmd->SetGuidance(
       "Set the number of pixel rings surrounding the central pixel");
   pixelRingsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // The field map and integration settings are shared, so they are only
+  // set on the master; every worker builds its field from them.
+  fieldDir = new G4UIdirectory("/NDD/field/");
+  fieldDir->SetGuidance("Magnetic field map, see NDDMagneticField.");
+
+  fieldMapCmd = new G4UIcmdWithAString("/NDD/field/map", this);
+  fieldMapCmd->SetGuidance(
+      "Binary field map from NDDFieldMapConvert, 'none' for no field.");
+  fieldMapCmd->SetParameterName("file", false);
+  fieldMapCmd->SetToBeBroadcasted(false);
+  fieldMapCmd->AvailableForStates(G4State_PreInit);
+
+  fieldScaleCmd = new G4UIcmdWithADouble("/NDD/field/scale", this);
+  fieldScaleCmd->SetGuidance("Factor applied to the field of the map.");
+  fieldScaleCmd->SetParameterName("scale", false);
+  fieldScaleCmd->SetToBeBroadcasted(false);
+  fieldScaleCmd->AvailableForStates(G4State_PreInit);
+
+  fieldOffsetCmd = new G4UIcmdWith3VectorAndUnit("/NDD/field/offset", this);
+  fieldOffsetCmd->SetGuidance("Position of the origin of the map in the world.");
+  fieldOffsetCmd->SetParameterName("x", "y", "z", false);
+  fieldOffsetCmd->SetUnitCategory("Length");
+  fieldOffsetCmd->SetDefaultUnit("mm");
+  fieldOffsetCmd->SetToBeBroadcasted(false);
+  fieldOffsetCmd->AvailableForStates(G4State_PreInit);
+
+  fieldStepperCmd = new G4UIcmdWithAString("/NDD/field/stepper", this);
+  fieldStepperCmd->SetGuidance("Runge-Kutta stepper for tracks in the field.");
+  fieldStepperCmd->SetParameterName("stepper", false);
+  fieldStepperCmd->SetCandidates("ClassicalRK4 CashKarpRKF45 DormandPrince745");
+  fieldStepperCmd->SetToBeBroadcasted(false);
+  fieldStepperCmd->AvailableForStates(G4State_PreInit);
+
+  fieldMinStepCmd = new G4UIcmdWithADoubleAndUnit("/NDD/field/minStep", this);
+  fieldMinStepCmd->SetGuidance("Smallest step of the chord finder.");
+  fieldMinStepCmd->SetParameterName("step", false);
+  fieldMinStepCmd->SetRange("step>0.");
+  fieldMinStepCmd->SetUnitCategory("Length");
+  fieldMinStepCmd->SetDefaultUnit("mm");
+  fieldMinStepCmd->SetToBeBroadcasted(false);
+  fieldMinStepCmd->AvailableForStates(G4State_PreInit);
+
+  fieldDeltaChordCmd = new G4UIcmdWithADoubleAndUnit("/NDD/field/deltaChord", this);
+  fieldDeltaChordCmd->SetGuidance(
+      "Largest distance between a chord and the true trajectory.");
+  fieldDeltaChordCmd->SetParameterName("delta", false);
+  fieldDeltaChordCmd->SetRange("delta>0.");
+  fieldDeltaChordCmd->SetUnitCategory("Length");
+  fieldDeltaChordCmd->SetDefaultUnit("mm");
+  fieldDeltaChordCmd->SetToBeBroadcasted(false);
+  fieldDeltaChordCmd->AvailableForStates(G4State_PreInit);
+
+  fieldDeltaOneStepCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/field/deltaOneStep", this);
+  fieldDeltaOneStepCmd->SetGuidance("Position accuracy of one step.");
+  fieldDeltaOneStepCmd->SetParameterName("delta", false);
+  fieldDeltaOneStepCmd->SetRange("delta>0.");
+  fieldDeltaOneStepCmd->SetUnitCategory("Length");
+  fieldDeltaOneStepCmd->SetDefaultUnit("mm");
+  fieldDeltaOneStepCmd->SetToBeBroadcasted(false);
+  fieldDeltaOneStepCmd->AvailableForStates(G4State_PreInit);
+
+  fieldDeltaIntersectionCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/field/deltaIntersection", this);
+  fieldDeltaIntersectionCmd->SetGuidance(
+      "Accuracy of the intersection with volume boundaries.");
+  fieldDeltaIntersectionCmd->SetParameterName("delta", false);
+  fieldDeltaIntersectionCmd->SetRange("delta>0.");
+  fieldDeltaIntersectionCmd->SetUnitCategory("Length");
+  fieldDeltaIntersectionCmd->SetDefaultUnit("mm");
+  fieldDeltaIntersectionCmd->SetToBeBroadcasted(false);
+  fieldDeltaIntersectionCmd->AvailableForStates(G4State_PreInit);
+
+  fieldEpsilonMinCmd = new G4UIcmdWithADouble("/NDD/field/epsilonMin", this);
+  fieldEpsilonMinCmd->SetGuidance("Smallest relative accuracy of a step.");
+  fieldEpsilonMinCmd->SetParameterName("epsilon", false);
+  fieldEpsilonMinCmd->SetRange("epsilon>0.");
+  fieldEpsilonMinCmd->SetToBeBroadcasted(false);
+  fieldEpsilonMinCmd->AvailableForStates(G4State_PreInit);
+
+  fieldEpsilonMaxCmd = new G4UIcmdWithADouble("/NDD/field/epsilonMax", this);
+  fieldEpsilonMaxCmd->SetGuidance("Largest relative accuracy of a step.");
+  fieldEpsilonMaxCmd->SetParameterName("epsilon", false);
+  fieldEpsilonMaxCmd->SetRange("epsilon>0.");
+  fieldEpsilonMaxCmd->SetToBeBroadcasted(false);
+  fieldEpsilonMaxCmd->AvailableForStates(G4State_PreInit);
+
+  electricDir = new G4UIdirectory("/NDD/field/electric/");
+  electricDir->SetGuidance(
+      "Electric field accelerating particles onto the detector, see "
+      "NDDElectricField.");
+
+  electricVoltageCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/field/electric/voltage", this);
+  electricVoltageCmd->SetGuidance(
+      "Detector voltage for a uniform field over the gap in front of it, "
+      "0 for none.");
+  electricVoltageCmd->SetParameterName("voltage", false);
+  electricVoltageCmd->SetUnitCategory("Electric potential");
+  electricVoltageCmd->SetDefaultUnit("kilovolt");
+  electricVoltageCmd->SetToBeBroadcasted(false);
+  electricVoltageCmd->AvailableForStates(G4State_PreInit);
+
+  electricGapCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/field/electric/gap", this);
+  electricGapCmd->SetGuidance(
+      "Distance from the grounded electrode to the detector face.");
+  electricGapCmd->SetParameterName("gap", false);
+  electricGapCmd->SetRange("gap>0.");
+  electricGapCmd->SetUnitCategory("Length");
+  electricGapCmd->SetDefaultUnit("mm");
+  electricGapCmd->SetToBeBroadcasted(false);
+  electricGapCmd->AvailableForStates(G4State_PreInit);
+
+  electricRadiusCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/field/electric/radius", this);
+  electricRadiusCmd->SetGuidance(
+      "Radius around the detector axis of the uniform field.");
+  electricRadiusCmd->SetParameterName("radius", false);
+  electricRadiusCmd->SetRange("radius>0.");
+  electricRadiusCmd->SetUnitCategory("Length");
+  electricRadiusCmd->SetDefaultUnit("mm");
+  electricRadiusCmd->SetToBeBroadcasted(false);
+  electricRadiusCmd->AvailableForStates(G4State_PreInit);
+
+  electricMapCmd = new G4UIcmdWithAString("/NDD/field/electric/map", this);
+  electricMapCmd->SetGuidance(
+      "Binary map in kV/mm from NDDFieldMapConvert, used instead of the "
+      "uniform field, 'none' for no map.");
+  electricMapCmd->SetParameterName("file", false);
+  electricMapCmd->SetToBeBroadcasted(false);
+  electricMapCmd->AvailableForStates(G4State_PreInit);
+
+  electricScaleCmd = new G4UIcmdWithADouble("/NDD/field/electric/scale", this);
+  electricScaleCmd->SetGuidance("Factor applied to the field of the map.");
+  electricScaleCmd->SetParameterName("scale", false);
+  electricScaleCmd->SetToBeBroadcasted(false);
+  electricScaleCmd->AvailableForStates(G4State_PreInit);
+
+  electricOffsetCmd =
+      new G4UIcmdWith3VectorAndUnit("/NDD/field/electric/offset", this);
+  electricOffsetCmd->SetGuidance(
+      "Position of the origin of the map in the world.");
+  electricOffsetCmd->SetParameterName("x", "y", "z", false);
+  electricOffsetCmd->SetUnitCategory("Length");
+  electricOffsetCmd->SetDefaultUnit("mm");
+  electricOffsetCmd->SetToBeBroadcasted(false);
+  electricOffsetCmd->AvailableForStates(G4State_PreInit);
+
+  guidingCentreDir = new G4UIdirectory("/NDD/guidingCentre/");
+  guidingCentreDir->SetGuidance(
+      "Guiding-centre transport in the vacuum, see NDDGuidingCentreModel.");
+
+  guidingCentreEnableCmd =
+      new G4UIcmdWithABool("/NDD/guidingCentre/enable", this);
+  guidingCentreEnableCmd->SetGuidance(
+      "Move charged particles in the vacuum along the field lines of the "
+      "field map instead of tracking every turn.");
+  guidingCentreEnableCmd->SetParameterName("enable", true);
+  guidingCentreEnableCmd->SetDefaultValue(true);
+  guidingCentreEnableCmd->SetToBeBroadcasted(false);
+  guidingCentreEnableCmd->AvailableForStates(G4State_PreInit);
+
+  guidingCentreMaxStepCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/guidingCentre/maxStep", this);
+  guidingCentreMaxStepCmd->SetGuidance("Longest step of the guiding centre.");
+  guidingCentreMaxStepCmd->SetParameterName("step", false);
+  guidingCentreMaxStepCmd->SetRange("step>0.");
+  guidingCentreMaxStepCmd->SetUnitCategory("Length");
+  guidingCentreMaxStepCmd->SetDefaultUnit("cm");
+  guidingCentreMaxStepCmd->SetToBeBroadcasted(false);
+  guidingCentreMaxStepCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  guidingCentreAdiabaticityCmd =
+      new G4UIcmdWithADouble("/NDD/guidingCentre/adiabaticity", this);
+  guidingCentreAdiabaticityCmd->SetGuidance(
+      "Largest gyroradius times |grad B| / B for which the model applies.");
+  guidingCentreAdiabaticityCmd->SetParameterName("adiabaticity", false);
+  guidingCentreAdiabaticityCmd->SetRange("adiabaticity>0.");
+  guidingCentreAdiabaticityCmd->SetToBeBroadcasted(false);
+  guidingCentreAdiabaticityCmd->AvailableForStates(G4State_PreInit,
+                                                   G4State_Idle);
+
+  guidingCentreMarginCmd =
+      new G4UIcmdWithADouble("/NDD/guidingCentre/margin", this);
+  guidingCentreMarginCmd->SetGuidance(
+      "Gyroradii from material, on top of the distance, at which tracks are "
+      "handed back to full tracking.");
+  guidingCentreMarginCmd->SetParameterName("margin", false);
+  guidingCentreMarginCmd->SetRange("margin>=1.");
+  guidingCentreMarginCmd->SetToBeBroadcasted(false);
+  guidingCentreMarginCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  guidingCentreDistanceCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/guidingCentre/distance", this);
+  guidingCentreDistanceCmd->SetGuidance(
+      "Distance to material at which tracks are handed back, beyond the "
+      "margin; the model takes over again at twice this distance.");
+  guidingCentreDistanceCmd->SetParameterName("distance", false);
+  guidingCentreDistanceCmd->SetRange("distance>0.");
+  guidingCentreDistanceCmd->SetUnitCategory("Length");
+  guidingCentreDistanceCmd->SetDefaultUnit("mm");
+  guidingCentreDistanceCmd->SetToBeBroadcasted(false);
+  guidingCentreDistanceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // The limits are shared by all threads and read during tracking, so they
+  // are set on the master only, between runs.
+  limitsDir = new G4UIdirectory("/NDD/limits/");
+  limitsDir->SetGuidance("Track killing conditions, see NDDUserLimits.");
+
+  limitsVolumeCmd = new G4UIcmdWithAString("/NDD/limits/volume", this);
+  limitsVolumeCmd->SetGuidance(
+      "Logical volume the following limits apply to, 'all' for the global "
+      "limits used wherever a volume sets none of its own.");
+  limitsVolumeCmd->SetParameterName("volume", false);
+  limitsVolumeCmd->SetToBeBroadcasted(false);
+  limitsVolumeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  limitsMaxTimeCmd = new G4UIcmdWithADoubleAndUnit("/NDD/limits/maxTime", this);
+  limitsMaxTimeCmd->SetGuidance(
+      "Kill tracks at this global time, the time since the decay.");
+  limitsMaxTimeCmd->SetGuidance(
+      "The first time or energy limit must be set before /run/initialize.");
+  limitsMaxTimeCmd->SetParameterName("time", false);
+  limitsMaxTimeCmd->SetRange("time>0.");
+  limitsMaxTimeCmd->SetUnitCategory("Time");
+  limitsMaxTimeCmd->SetDefaultUnit("ns");
+  limitsMaxTimeCmd->SetToBeBroadcasted(false);
+  limitsMaxTimeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  limitsMinEkinCmd = new G4UIcommand("/NDD/limits/minEkin", this);
+  limitsMinEkinCmd->SetGuidance(
+      "Kill tracks of a particle below a kinetic energy, depositing it "
+      "locally; 'all' for every particle without a value of its own.");
+  limitsMinEkinCmd->SetGuidance(
+      "The first time or energy limit must be set before /run/initialize.");
+  limitsMinEkinCmd->SetParameter(new G4UIparameter("particle", 's', false));
+  G4UIparameter* minEkinParam = new G4UIparameter("energy", 'd', false);
+  minEkinParam->SetParameterRange("energy>=0.");
+  limitsMinEkinCmd->SetParameter(minEkinParam);
+  G4UIparameter* minEkinUnitParam = new G4UIparameter("unit", 's', true);
+  minEkinUnitParam->SetDefaultValue("keV");
+  limitsMinEkinCmd->SetParameter(minEkinUnitParam);
+  limitsMinEkinCmd->SetToBeBroadcasted(false);
+  limitsMinEkinCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  limitsMaxDistanceCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/limits/maxDistance", this);
+  limitsMaxDistanceCmd->SetGuidance(
+      "Kill tracks beyond this distance from the face of every detector and "
+      "moving away from each of them, 0 for no limit.");
+  limitsMaxDistanceCmd->SetParameterName("distance", false);
+  limitsMaxDistanceCmd->SetRange("distance>=0.");
+  limitsMaxDistanceCmd->SetUnitCategory("Length");
+  limitsMaxDistanceCmd->SetDefaultUnit("cm");
+  limitsMaxDistanceCmd->SetToBeBroadcasted(false);
+  limitsMaxDistanceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 NDDDetectorMessenger::~NDDDetectorMessenger() {
   delete geomDir;
   delete sourceIDCmd;
   delete sourcePosCmd;
+  delete addDetectorCmd;
+  delete detPosCmd;
   delete pixelRingsCmd;
+  delete fieldMapCmd;
+  delete fieldScaleCmd;
+  delete fieldOffsetCmd;
+  delete fieldStepperCmd;
+  delete fieldMinStepCmd;
+  delete fieldDeltaChordCmd;
+  delete fieldDeltaOneStepCmd;
+  delete fieldDeltaIntersectionCmd;
+  delete fieldEpsilonMinCmd;
+  delete fieldEpsilonMaxCmd;
+  delete electricVoltageCmd;
+  delete electricGapCmd;
+  delete electricRadiusCmd;
+  delete electricMapCmd;
+  delete electricScaleCmd;
+  delete electricOffsetCmd;
+  delete electricDir;
+  delete fieldDir;
+  delete guidingCentreEnableCmd;
+  delete guidingCentreMaxStepCmd;
+  delete guidingCentreAdiabaticityCmd;
+  delete guidingCentreMarginCmd;
+  delete guidingCentreDistanceCmd;
+  delete guidingCentreDir;
+  delete limitsVolumeCmd;
+  delete limitsMaxTimeCmd;
+  delete limitsMinEkinCmd;
+  delete limitsMaxDistanceCmd;
+  delete limitsDir;
 }
 
 void NDDDetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
@@ -51,7 +359,89 @@ void NDDDetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
         detector->AddSourcePosition(sourcePosCmd->GetNew3VectorValue(newValue));
     } else if (command == pixelRingsCmd) {
         detector->SetPixelRings(pixelRingsCmd->GetNewIntValue(newValue));
+    } else if (command == addDetectorCmd) {
+        detector->AddDetector(newValue);
     } else if (command == detPosCmd) {
         detector->SetDetectorPosition(detPosCmd->GetNew3VectorValue(newValue));
+    } else if (command == fieldMapCmd) {
+        NDDMagneticField::SetMap(newValue);
+    } else if (command == fieldScaleCmd) {
+        NDDMagneticField::SetScale(fieldScaleCmd->GetNewDoubleValue(newValue));
+    } else if (command == fieldOffsetCmd) {
+        NDDMagneticField::SetOffset(fieldOffsetCmd->GetNew3VectorValue(newValue));
+    } else if (command == fieldStepperCmd) {
+        NDDMagneticField::GetIntegration().stepper = newValue;
+    } else if (command == fieldMinStepCmd) {
+        NDDMagneticField::GetIntegration().minStep =
+            fieldMinStepCmd->GetNewDoubleValue(newValue);
+    } else if (command == fieldDeltaChordCmd) {
+        NDDMagneticField::GetIntegration().deltaChord =
+            fieldDeltaChordCmd->GetNewDoubleValue(newValue);
+    } else if (command == fieldDeltaOneStepCmd) {
+        NDDMagneticField::GetIntegration().deltaOneStep =
+            fieldDeltaOneStepCmd->GetNewDoubleValue(newValue);
+    } else if (command == fieldDeltaIntersectionCmd) {
+        NDDMagneticField::GetIntegration().deltaIntersection =
+            fieldDeltaIntersectionCmd->GetNewDoubleValue(newValue);
+    } else if (command == fieldEpsilonMinCmd) {
+        NDDMagneticField::GetIntegration().epsilonMin =
+            fieldEpsilonMinCmd->GetNewDoubleValue(newValue);
+    } else if (command == fieldEpsilonMaxCmd) {
+        NDDMagneticField::GetIntegration().epsilonMax =
+            fieldEpsilonMaxCmd->GetNewDoubleValue(newValue);
+    } else if (command == electricVoltageCmd) {
+        NDDElectricField::SetVoltage(
+            electricVoltageCmd->GetNewDoubleValue(newValue));
+    } else if (command == electricGapCmd) {
+        NDDElectricField::SetGap(electricGapCmd->GetNewDoubleValue(newValue));
+    } else if (command == electricRadiusCmd) {
+        NDDElectricField::SetRadius(
+            electricRadiusCmd->GetNewDoubleValue(newValue));
+    } else if (command == electricMapCmd) {
+        NDDElectricField::SetMap(newValue);
+    } else if (command == electricScaleCmd) {
+        NDDElectricField::SetScale(
+            electricScaleCmd->GetNewDoubleValue(newValue));
+    } else if (command == electricOffsetCmd) {
+        NDDElectricField::SetOffset(
+            electricOffsetCmd->GetNew3VectorValue(newValue));
+    } else if (command == guidingCentreEnableCmd) {
+        NDDGuidingCentreModel::SetEnabled(
+            guidingCentreEnableCmd->GetNewBoolValue(newValue));
+    } else if (command == guidingCentreMaxStepCmd) {
+        NDDGuidingCentreModel::SetMaxStep(
+            guidingCentreMaxStepCmd->GetNewDoubleValue(newValue));
+    } else if (command == guidingCentreAdiabaticityCmd) {
+        NDDGuidingCentreModel::SetAdiabaticity(
+            guidingCentreAdiabaticityCmd->GetNewDoubleValue(newValue));
+    } else if (command == guidingCentreMarginCmd) {
+        NDDGuidingCentreModel::SetMargin(
+            guidingCentreMarginCmd->GetNewDoubleValue(newValue));
+    } else if (command == guidingCentreDistanceCmd) {
+        NDDGuidingCentreModel::SetDistance(
+            guidingCentreDistanceCmd->GetNewDoubleValue(newValue));
+    } else if (command == limitsVolumeCmd) {
+        limitsVolume = newValue;
+    } else if ((command == limitsMaxTimeCmd || command == limitsMinEkinCmd) &&
+               !NDDUserLimits::IsTimeOrEnergyLimited() &&
+               G4StateManager::GetStateManager()->GetCurrentState() !=
+                   G4State_PreInit) {
+        // the process enforcing them is only attached at /run/initialize
+        G4cout << "ERROR: " << command->GetCommandPath()
+               << " needs a time or energy limit set before /run/initialize"
+               << G4endl;
+    } else if (command == limitsMaxTimeCmd) {
+        NDDUserLimits::Get(limitsVolume)->SetMaxTime(
+            limitsMaxTimeCmd->GetNewDoubleValue(newValue));
+    } else if (command == limitsMinEkinCmd) {
+        G4String particle, unit;
+        G4double energy;
+        std::istringstream is(newValue);
+        is >> particle >> energy >> unit;
+        NDDUserLimits::Get(limitsVolume)->SetMinEkin(
+            particle, energy * G4UIcommand::ValueOf(unit));
+    } else if (command == limitsMaxDistanceCmd) {
+        NDDUserLimits::Get(limitsVolume)->SetMaxDistance(
+            limitsMaxDistanceCmd->GetNewDoubleValue(newValue));
     }
 }
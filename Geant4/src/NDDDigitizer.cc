@@ -0,0 +1,314 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDDigitizer.hh"
+#include "NDDDigitizerMessenger.hh"
+#include "NDDPixelMap.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+const NDDPixelResponseMap* NDDDigitizer::responseMap = nullptr;
+const NDDPulseTemplates* NDDDigitizer::templates = nullptr;
+G4double NDDDigitizer::samplePeriod = 1. * ns;
+G4int NDDDigitizer::nSamples = 512;
+G4double NDDDigitizer::preTrigger = 20. * ns;
+NDDShaping NDDDigitizer::shaping = {NDDShaping::kNone, 0., 0, 0., 0., 0.};
+NDDDigitizerMessenger* NDDDigitizer::messenger = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDDigitizer::CreateMessenger() {
+  if (!messenger) messenger = new NDDDigitizerMessenger();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDDigitizer::DeleteMessenger() {
+  delete messenger;
+  messenger = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDDigitizer::NDDDigitizer() : startTime(0.) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDDigitizer::SetResponseMap(const G4String& filename) {
+  if (filename == "none") {
+    responseMap = nullptr;
+    return true;
+  }
+  const NDDPixelResponseMap* map = NDDPixelResponseMap::Load(filename);
+  if (!map) return false;
+  responseMap = map;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDDigitizer::SetTemplates(const G4String& filename) {
+  if (filename == "none") {
+    templates = nullptr;
+    return true;
+  }
+  const NDDPulseTemplates* library = NDDPulseTemplates::Load(filename);
+  if (!library) return false;
+  templates = library;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int NDDDigitizer::GetWaveform(G4int pixelNumber) {
+  if (pixelNumber >= (G4int)waveformOf.size()) {
+    waveformOf.resize(pixelNumber + 1, -1);
+  }
+  if (waveformOf[pixelNumber] < 0) {
+    waveformOf[pixelNumber] = waveforms.size();
+    NDDPixelWaveform w;
+    w.pixelNumber = pixelNumber;
+    w.samples.assign(nSamples, 0.);
+    waveforms.push_back(w);
+    tails.push_back(std::vector<G4double>(nSamples, 0.));
+  }
+  return waveformOf[pixelNumber];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::vector<NDDPixelWaveform>& NDDDigitizer::Digitize(
+    NDDSiPixelHitsCollection* hc) {
+  for (const NDDPixelWaveform& w : waveforms) waveformOf[w.pixelNumber] = -1;
+  waveforms.clear();
+  tails.clear();
+
+  G4int nHits = hc->entries();
+  if (!IsEnabled() || nHits == 0) return waveforms;
+
+  G4double tFirst = DBL_MAX;
+  for (G4int i = 0; i < nHits; i++) {
+    tFirst = std::min(tFirst, (*hc)[i]->GetTime());
+  }
+  startTime = tFirst - preTrigger;
+
+  if (templates) {
+    for (G4int i = 0; i < nHits; i++) AddTemplateHit((*hc)[i]);
+  } else {
+    for (G4int i = 0; i < nHits; i++) AddHit((*hc)[i]);
+  }
+
+  // the step changes hold from the sample they happen on to the end
+  for (size_t k = 0; k < waveforms.size(); k++) {
+    std::vector<G4double>& samples = waveforms[k].samples;
+    const std::vector<G4double>& tail = tails[k];
+    G4double level = 0.;
+    for (G4int s = 0; s < nSamples; s++) {
+      level += tail[s];
+      samples[s] += level;
+    }
+  }
+
+  if (waveforms.empty()) return waveforms;
+  batch.Resize(waveforms.size(), nSamples, GetSamplePeriod());
+  for (size_t k = 0; k < waveforms.size(); k++) {
+    batch.SetWaveform(k, &waveforms[k].samples[0], nSamples);
+  }
+  if (shaping.type != NDDShaping::kNone) {
+    batch.Shape(shaping);
+    for (size_t k = 0; k < waveforms.size(); k++) {
+      batch.GetWaveform(k, &waveforms[k].samples[0]);
+    }
+  }
+  batch.Extract(0.1, 0.9, features);
+  for (size_t k = 0; k < waveforms.size(); k++) {
+    waveforms[k].features = features[k];
+  }
+  return waveforms;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDDigitizer::AddHit(const NDDSiPixelHit* hit) {
+  G4int pixel = hit->GetPixelNumber();
+  G4ThreeVector local = hit->GetLocalPos();
+  if (pixel < 1 || hit->GetEnDep() <= 0) return;
+
+  // the drift times come from the column under the hit
+  NDDPixelResponseMap::Column own;
+  if (!responseMap->GetColumn(local.x(), local.y(), own)) return;
+
+  targets.clear();
+  const NDDPixelMap* pixelMap = NDDPixelMap::Instance();
+  if (pixelMap->GetNumberOfPixels() < pixel) {
+    Target t = {GetWaveform(pixel), own, 0.};
+    targets.push_back(t);
+  } else {
+    // only pixels whose centre can be inside the (square) map
+    G4ThreeVector offset = local + pixelMap->GetCentre(pixel);
+    G4double reach = std::sqrt(2.) * responseMap->GetHalfWidth();
+    pixelMap->GetPixelsWithin(pixel, pixelMap->GetStepsWithin(reach), inReach);
+    for (G4int k : inReach) {
+      Target t;
+      G4ThreeVector shifted = offset - pixelMap->GetCentre(k);
+      if (!responseMap->GetColumn(shifted.x(), shifted.y(), t.column)) continue;
+      t.waveform = GetWaveform(k);
+      targets.push_back(t);
+    }
+  }
+
+  G4int nz = responseMap->GetNz();
+  potential.resize(targets.size() * nz);
+  for (size_t k = 0; k < targets.size(); k++) {
+    responseMap->GetWColumn(targets[k].column, &potential[k * nz]);
+    targets[k].w0 = responseMap->GetW(targets[k].column, local.z());
+  }
+
+  G4double scale = hit->GetEnDep() / keV;
+  AddCarrier(own, true, local.z(), hit->GetTime(), scale);
+  AddCarrier(own, false, local.z(), hit->GetTime(), -scale);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDDigitizer::AddCarrier(const NDDPixelResponseMap::Column& own,
+                              G4bool collected, G4double z0, G4double t0,
+                              G4double scale) {
+  G4int nz = responseMap->GetNz();
+  z0 = std::max(responseMap->GetZMin(), std::min(z0, responseMap->GetZMax()));
+  G4double fz = (z0 - responseMap->GetZMin()) /
+                (responseMap->GetZ(1) - responseMap->GetZ(0));
+
+  // grid planes crossed on the way to the electrode, in drift order
+  nodePlane.clear();
+  if (collected == responseMap->IsPixelSideLow()) {
+    for (G4int iz = std::min((G4int)std::floor(fz), nz - 1); iz >= 0; iz--) {
+      nodePlane.push_back(iz);
+    }
+  } else {
+    for (G4int iz = std::max((G4int)std::ceil(fz), 0); iz < nz; iz++) {
+      nodePlane.push_back(iz);
+    }
+  }
+  if (nodePlane.empty()) return;
+
+  // the map holds the time left to the electrode
+  ownTimes.resize(nz);
+  responseMap->GetTimeColumn(own, collected, &ownTimes[0]);
+  G4double tLeft = responseMap->GetTime(own, collected, z0);
+  nodeTime.resize(nodePlane.size());
+  G4double previous = t0;
+  for (size_t j = 0; j < nodePlane.size(); j++) {
+    previous = std::max(previous, t0 + tLeft - ownTimes[nodePlane[j]]);
+    nodeTime[j] = previous;
+  }
+
+  for (size_t k = 0; k < targets.size(); k++) {
+    const G4double* w = &potential[k * nz];
+    G4double wPrevious = targets[k].w0;
+    G4double tPrevious = t0;
+    for (size_t j = 0; j < nodePlane.size(); j++) {
+      G4double wNode = w[nodePlane[j]];
+      AddSegment(targets[k].waveform, tPrevious, nodeTime[j],
+                 scale * (wNode - wPrevious));
+      wPrevious = wNode;
+      tPrevious = nodeTime[j];
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDDigitizer::AddSegment(G4int waveform, G4double ta, G4double tb,
+                              G4double dQ) {
+  if (dQ == 0.) return;
+
+  // in units of samples from the start of the waveform
+  G4double xa = (ta - startTime) / samplePeriod;
+  G4double xb = (tb - startTime) / samplePeriod;
+  if (xa >= nSamples) return;
+  G4int sEnd = xb >= nSamples ? nSamples : std::max(0, (G4int)std::ceil(xb));
+
+  // linear ramp while the carrier moves between the planes...
+  if (xb > xa) {
+    std::vector<G4double>& samples = waveforms[waveform].samples;
+    G4double slope = dQ / (xb - xa);
+    for (G4int s = std::max(0, (G4int)std::ceil(xa)); s < sEnd; s++) {
+      samples[s] += slope * (s - xa);
+    }
+  }
+  // ...and the full change from then on
+  if (sEnd < nSamples) tails[waveform][sEnd] += dQ;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDDigitizer::AddTemplateHit(const NDDSiPixelHit* hit) {
+  G4int pixel = hit->GetPixelNumber();
+  G4ThreeVector local = hit->GetLocalPos();
+  if (pixel < 1 || hit->GetEnDep() <= 0) return;
+
+  // the hit time falls between samples first and first + 1
+  G4double x = (hit->GetTime() - startTime) / templates->GetPeriod();
+  G4int first = (G4int)std::floor(x);
+  if (first >= nSamples) return;
+  G4double scale = hit->GetEnDep() / keV;
+
+  NDDPulseTemplates::Weights w;
+  const NDDPixelMap* pixelMap = NDDPixelMap::Instance();
+  if (pixelMap->GetNumberOfPixels() < pixel) {
+    if (templates->GetWeights(local.z(), local.x(), local.y(), w)) {
+      AddTemplate(GetWaveform(pixel), w, first, x - first, scale);
+    }
+    return;
+  }
+
+  G4ThreeVector offset = local + pixelMap->GetCentre(pixel);
+  pixelMap->GetPixelsWithin(
+      pixel, pixelMap->GetStepsWithin(templates->GetMaxRadius()), inReach);
+  for (G4int k : inReach) {
+    G4ThreeVector d = offset - pixelMap->GetCentre(k);
+    if (!templates->GetWeights(local.z(), d.x(), d.y(), w)) continue;
+    AddTemplate(GetWaveform(k), w, first, x - first, scale);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDDigitizer::AddTemplate(G4int waveform,
+                               const NDDPulseTemplates::Weights& w,
+                               G4int first, G4double fraction,
+                               G4double scale) {
+  G4int length = templates->GetNumberOfSamples();
+
+  // interpolate the template, a loop the compiler vectorizes
+  combined.assign(length, 0.);
+  G4double* c = &combined[0];
+  for (G4int i = 0; i < w.n; i++) {
+    const G4float* t = w.templ[i];
+    G4double a = scale * w.weight[i];
+    for (G4int s = 0; s < length; s++) c[s] += a * t[s];
+  }
+
+  // shifted to the hit time, split between the two neighbouring samples
+  G4double* samples = &waveforms[waveform].samples[0];
+  G4double a0 = 1. - fraction, a1 = fraction;
+  G4int n0 = std::min(length, nSamples - first);
+  G4int n1 = std::min(length, nSamples - first - 1);
+  for (G4int s = 0; s < n0; s++) samples[first + s] += a0 * c[s];
+  for (G4int s = 0; s < n1; s++) samples[first + 1 + s] += a1 * c[s];
+
+  // the last value holds to the end of the waveform
+  std::vector<G4double>& tail = tails[waveform];
+  if (first + length < nSamples) tail[first + length] += a0 * c[length - 1];
+  if (first + length + 1 < nSamples) {
+    tail[first + length + 1] += a1 * c[length - 1];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,160 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDDigitizerMessenger.hh"
+#include "NDDDigitizer.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDDigitizerMessenger::NDDDigitizerMessenger()
+    : G4UImessenger(),
+      digitizerDir(0),
+      digitizerMapCmd(0),
+      digitizerTemplatesCmd(0),
+      digitizerPeriodCmd(0),
+      digitizerSamplesCmd(0),
+      digitizerPreTriggerCmd(0),
+      digitizerShaperCmd(0) {
+  digitizerDir = new G4UIdirectory("/NDD/digitizer/");
+  digitizerDir->SetGuidance("Pixel waveforms from the hits, see NDDDigitizer.");
+
+  digitizerMapCmd = new G4UIcmdWithAString("/NDD/digitizer/map", this);
+  digitizerMapCmd->SetGuidance(
+      "Pixel response map from SSD/ExportResponseMap.jl, 'none' to disable.");
+  digitizerMapCmd->SetGuidance("Waveforms are written to the waveforms ntuple.");
+  digitizerMapCmd->SetParameterName("file", false);
+  digitizerMapCmd->SetToBeBroadcasted(false);
+  digitizerMapCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  digitizerTemplatesCmd = new G4UIcmdWithAString("/NDD/digitizer/templates", this);
+  digitizerTemplatesCmd->SetGuidance(
+      "Pulse template library from SSD/ExportPulseTemplates.jl, 'none' to disable.");
+  digitizerTemplatesCmd->SetGuidance(
+      "Takes precedence over the map, and sets the sample period.");
+  digitizerTemplatesCmd->SetParameterName("file", false);
+  digitizerTemplatesCmd->SetToBeBroadcasted(false);
+  digitizerTemplatesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  digitizerPeriodCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/digitizer/samplePeriod", this);
+  digitizerPeriodCmd->SetGuidance("Time between waveform samples.");
+  digitizerPeriodCmd->SetGuidance("Template libraries use their own period.");
+  digitizerPeriodCmd->SetParameterName("period", false);
+  digitizerPeriodCmd->SetRange("period>0.");
+  digitizerPeriodCmd->SetUnitCategory("Time");
+  digitizerPeriodCmd->SetDefaultUnit("ns");
+  digitizerPeriodCmd->SetToBeBroadcasted(false);
+  digitizerPeriodCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  digitizerSamplesCmd =
+      new G4UIcmdWithAnInteger("/NDD/digitizer/samples", this);
+  digitizerSamplesCmd->SetGuidance("Number of samples per waveform.");
+  digitizerSamplesCmd->SetParameterName("n", false);
+  digitizerSamplesCmd->SetRange("n>0");
+  digitizerSamplesCmd->SetToBeBroadcasted(false);
+  digitizerSamplesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  digitizerPreTriggerCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/digitizer/preTrigger", this);
+  digitizerPreTriggerCmd->SetGuidance(
+      "Baseline kept before the earliest hit of the event.");
+  digitizerPreTriggerCmd->SetParameterName("preTrigger", false);
+  digitizerPreTriggerCmd->SetRange("preTrigger>=0.");
+  digitizerPreTriggerCmd->SetUnitCategory("Time");
+  digitizerPreTriggerCmd->SetDefaultUnit("ns");
+  digitizerPreTriggerCmd->SetToBeBroadcasted(false);
+  digitizerPreTriggerCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  digitizerShaperCmd = new G4UIcommand("/NDD/digitizer/shaper", this);
+  digitizerShaperCmd->SetGuidance("Shaping of the waveforms before they are written.");
+  digitizerShaperCmd->SetGuidance("  crrc <tau> <n> [decay]          CR-RC^n");
+  digitizerShaperCmd->SetGuidance("  trapezoid <rise> <flat> [decay] trapezoidal filter");
+  digitizerShaperCmd->SetGuidance("  none");
+  digitizerShaperCmd->SetGuidance(
+      "Times in ns; decay is the preamplifier decay to pole-zero correct.");
+  G4UIparameter* shaperParam = new G4UIparameter("type", 's', false);
+  shaperParam->SetParameterCandidates("none crrc trapezoid");
+  digitizerShaperCmd->SetParameter(shaperParam);
+  G4UIparameter* shaperFirstParam = new G4UIparameter("first", 'd', true);
+  shaperFirstParam->SetDefaultValue(0.);
+  digitizerShaperCmd->SetParameter(shaperFirstParam);
+  G4UIparameter* shaperSecondParam = new G4UIparameter("second", 'd', true);
+  shaperSecondParam->SetDefaultValue(0.);
+  digitizerShaperCmd->SetParameter(shaperSecondParam);
+  G4UIparameter* shaperDecayParam = new G4UIparameter("decay", 'd', true);
+  shaperDecayParam->SetDefaultValue(0.);
+  digitizerShaperCmd->SetParameter(shaperDecayParam);
+  digitizerShaperCmd->SetToBeBroadcasted(false);
+  digitizerShaperCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDDigitizerMessenger::~NDDDigitizerMessenger() {
+  delete digitizerMapCmd;
+  delete digitizerTemplatesCmd;
+  delete digitizerPeriodCmd;
+  delete digitizerSamplesCmd;
+  delete digitizerPreTriggerCmd;
+  delete digitizerShaperCmd;
+  delete digitizerDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDDigitizerMessenger::SetNewValue(G4UIcommand* command,
+                                        G4String newValues) {
+  if (command == digitizerMapCmd) NDDDigitizer::SetResponseMap(newValues);
+
+  if (command == digitizerTemplatesCmd) NDDDigitizer::SetTemplates(newValues);
+
+  if (command == digitizerPeriodCmd)
+    NDDDigitizer::SetSamplePeriod(
+        digitizerPeriodCmd->GetNewDoubleValue(newValues));
+
+  if (command == digitizerSamplesCmd)
+    NDDDigitizer::SetNumberOfSamples(
+        digitizerSamplesCmd->GetNewIntValue(newValues));
+
+  if (command == digitizerPreTriggerCmd)
+    NDDDigitizer::SetPreTrigger(
+        digitizerPreTriggerCmd->GetNewDoubleValue(newValues));
+
+  if (command == digitizerShaperCmd) {
+    std::istringstream is(newValues);
+    G4String type;
+    G4double first, second, decay;
+    is >> type >> first >> second >> decay;
+    NDDShaping shaping = {NDDShaping::kNone, 0., 0, 0., 0., decay * ns};
+    if (type == "crrc") {
+      if (first <= 0 || second < 1) {
+        G4cout << "ERROR: crrc needs a time constant and an order >= 1" << G4endl;
+        return;
+      }
+      shaping.type = NDDShaping::kCRRC;
+      shaping.tau = first * ns;
+      shaping.order = (G4int)second;
+    } else if (type == "trapezoid") {
+      if (first <= 0 || second < 0) {
+        G4cout << "ERROR: trapezoid needs a rise time and a flat top" << G4endl;
+        return;
+      }
+      shaping.type = NDDShaping::kTrapezoid;
+      shaping.rise = first * ns;
+      shaping.flat = second * ns;
+    }
+    NDDDigitizer::SetShaping(shaping);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,106 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDElectricField.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+G4double NDDElectricField::voltage = 0.;
+G4double NDDElectricField::gap = 5. * mm;
+G4double NDDElectricField::radius = 7.5 * cm;
+const NDDFieldMap* NDDElectricField::fieldMap = nullptr;
+G4double NDDElectricField::scale = 1.;
+G4ThreeVector NDDElectricField::offset;
+std::vector<NDDElectricField::Face> NDDElectricField::faces;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDElectricField::NDDElectricField(const G4MagneticField* m)
+    : G4ElectroMagneticField(), magnetic(m), interpolator(0), uniformField(0.) {
+  if (fieldMap) {
+    interpolator = new NDDFieldMapInterpolator(fieldMap, scale, offset);
+    for (G4int a = 0; a < 3; a++) {
+      lower[a] = fieldMap->GetMin(a) + offset[a];
+      upper[a] = lower[a] + (fieldMap->GetN(a) - 1) * fieldMap->GetStep(a);
+    }
+    // the first axis of an axisymmetric map is r
+    if (fieldMap->GetDimension() == 2) {
+      G4double r = upper[0] - offset[0];
+      for (G4int a = 0; a < 2; a++) {
+        lower[a] = offset[a] - r;
+        upper[a] = offset[a] + r;
+      }
+    }
+  } else {
+    // from ground at the far end of the gap to the voltage at the face, for
+    // a detector looking towards -z
+    uniformField = -voltage / gap;
+    for (G4int a = 0; a < 3; a++) {
+      lower[a] = DBL_MAX;
+      upper[a] = -DBL_MAX;
+    }
+    for (const Face& f : faces) {
+      G4double z = f.position.z() - f.side * gap;
+      for (G4int a = 0; a < 2; a++) {
+        lower[a] = std::min(lower[a], f.position[a] - radius);
+        upper[a] = std::max(upper[a], f.position[a] + radius);
+      }
+      lower[2] = std::min(lower[2], std::min(z, f.position.z()));
+      upper[2] = std::max(upper[2], std::max(z, f.position.z()));
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDElectricField::~NDDElectricField() { delete interpolator; }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDElectricField::SetMap(const G4String& filename) {
+  if (filename == "none") {
+    fieldMap = nullptr;
+    return true;
+  }
+  const NDDFieldMap* m = NDDFieldMap::Load(filename, kilovolt / mm);
+  if (!m) return false;
+  fieldMap = m;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDElectricField::GetFieldValue(const G4double point[4],
+                                     G4double* field) const {
+  if (magnetic) {
+    magnetic->GetFieldValue(point, field);
+  } else {
+    field[0] = field[1] = field[2] = 0.;
+  }
+  field[3] = field[4] = field[5] = 0.;
+
+  for (G4int a = 0; a < 3; a++) {
+    if (point[a] < lower[a] || point[a] > upper[a]) return;
+  }
+  if (interpolator) {
+    interpolator->Evaluate(point, field + 3);
+    return;
+  }
+  for (const Face& f : faces) {
+    // depth in front of the face
+    G4double depth = (f.position.z() - point[2]) * f.side;
+    if (depth < 0 || depth > gap) continue;
+    G4double dx = point[0] - f.position.x();
+    G4double dy = point[1] - f.position.y();
+    if (dx * dx + dy * dy <= radius * radius) {
+      field[5] = f.side * uniformField;
+      return;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
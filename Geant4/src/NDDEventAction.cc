@@ -4,17 +4,38 @@
 #include "NDDEventAction.hh"
 #include "NDDRunAction.hh"
 #include "NDDSiPixelHit.hh"
+#include "NDDSurrogateEventInformation.hh"
+#include "NDDPrecisionMonitor.hh"
+#include "NDDEventFilter.hh"
+#include "NDDHitStream.hh"
+#include "NDDProfiler.hh"
+#include "NDDPixelSpectra.hh"
+#include "NDDPixelMap.hh"
+#include "NDDPassiveSD.hh"
 #include "NDDAnalysis.hh"
 
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
 #include "G4RunManager.hh"
 #include "Randomize.hh"
 #include "G4SDManager.hh"
 
+#include <algorithm>
+#include <cmath>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-NDDEventAction::NDDEventAction() : G4UserEventAction() {
-}
+NDDEventAction::NDDEventAction(NDDRunAction* ra)
+    : G4UserEventAction(),
+      runAction(ra),
+      profiler(NDDProfiler::Instance()),
+      hitStream(NDDHitStream::Instance()),
+      deadSD(nullptr),
+      backingSD(nullptr),
+      foilSD(nullptr),
+      carrierSD(nullptr),
+      sourceHolderSD(nullptr) {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -23,11 +44,29 @@ NDDEventAction::~NDDEventAction() {}
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void NDDEventAction::BeginOfEventAction(const G4Event* evt) {
+  if (NDDProfiler::IsEnabled()) profiler->BeginEvent(evt->GetEventID());
+
   Clear();
 
+  G4PrimaryVertex* vertex = evt->GetPrimaryVertex();
+  if (vertex && vertex->GetPrimary()) {
+    enPrimary = vertex->GetPrimary()->GetKineticEnergy();
+  }
+
   auto sdMan = G4SDManager::GetSDMpointer();
 
   SiHCiD = sdMan->GetCollectionID("SiPixelHitCollection");
+
+  // none for volumes missing from the geometry
+  auto passiveSD = [&](const char* name) {
+    return static_cast<NDDPassiveSD*>(
+        sdMan->FindSensitiveDetector(G4String("/NDD/") + name, false));
+  };
+  deadSD = passiveSD("Dead");
+  backingSD = passiveSD("Backing");
+  foilSD = passiveSD("Foil");
+  carrierSD = passiveSD("Carrier");
+  sourceHolderSD = passiveSD("SourceHolder");
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -45,7 +84,17 @@ void NDDEventAction::EndOfEventAction(const G4Event* evt) {
     }
   }*/
 
+  const NDDSurrogateEventInformation* surrogateInfo =
+      dynamic_cast<const NDDSurrogateEventInformation*>(
+          evt->GetUserInformation());
+  if (surrogateInfo) {
+    EndOfSurrogateEvent(evt->GetEventID(), surrogateInfo);
+    if (NDDProfiler::IsEnabled()) profiler->EndEvent();
+    return;
+  }
+
   classification = ClassifyEvent();
+  CollectPassiveDeposits();
 
   G4HCofThisEvent* hce = evt->GetHCofThisEvent();
   NDDSiPixelHitsCollection* SiPixelHC = 0;
@@ -55,16 +104,13 @@ void NDDEventAction::EndOfEventAction(const G4Event* evt) {
   G4int nrHits = SiPixelHC->entries();
 
   std::vector<G4double> pixelEnDep;
-  pixelEnDep.resize(128);
+  pixelEnDep.resize(NDDPixelMap::Instance()->GetNumberOfPixels());
+
+  G4bool fill2D = runAction->Histograms2DEnabled();
 
   for (G4int iHit = 0; iHit < nrHits; iHit++) {
     NDDSiPixelHit* hit = (*SiPixelHC)[iHit];
     G4ThreeVector pos = hit->GetPos();
-    G4ThreeVector mom = hit->GetMomentum();
-    G4String particleType = hit->GetParticleCode();
-    FillHitsTuple(evt->GetEventID(), classification, enPrimary,
-                            hit->GetEnDep(), pos.x(), pos.y(), pos.z(), mom.x(),
-                            mom.y(), mom.z(), hit->GetTime(), 1, 0);
 
     enDepSi += hit->GetEnDep();
     if (iHit == 0) {
@@ -72,42 +118,172 @@ void NDDEventAction::EndOfEventAction(const G4Event* evt) {
       poeXSi = pos.x();
       poeYSi = pos.y();
     }
-    FillH2Hist(1, std::abs(pos.z()), pos.x());
+    if (fill2D) FillH2Hist(1, std::abs(pos.z()), pos.x());
 
-    pixelEnDep[hit->GetPixelNumber() - 1] += hit->GetEnDep();
+    G4int pixel = hit->GetPixelNumber();
+    if (pixel > (G4int)pixelEnDep.size()) pixelEnDep.resize(pixel);
+    pixelEnDep[pixel - 1] += hit->GetEnDep();
   }
 
-  FillSpacetimeTuple(evt->GetEventID(), classification,
-                    angleSourceOut, angleSiOut, timeSi, poeXSi, poeYSi);
+  // with charge sharing the pixels see the shared deposits instead
+  const std::vector<NDDPixelDeposit>* shared = nullptr;
+  if (nrHits > 0 && NDDChargeSharing::IsEnabled()) {
+    shared = &sharing.Share(SiPixelHC);
+    std::fill(pixelEnDep.begin(), pixelEnDep.end(), 0.);
+    for (const NDDPixelDeposit& d : *shared) {
+      if (d.pixelNumber < 1) continue;
+      if (d.pixelNumber > (G4int)pixelEnDep.size()) pixelEnDep.resize(d.pixelNumber);
+      pixelEnDep[d.pixelNumber - 1] += d.eDep;
+    }
+  }
 
-  FillH2Hist(0, poeXSi, poeYSi);
+  if (fill2D) FillH2Hist(0, poeXSi, poeYSi);
+
+  if (runAction->GeneralHistogramsEnabled()) {
+    if (enDepSi > 0) FillH1Hist(1, enDepSi);
+    if (enDepDead > 0) FillH1Hist(2, enDepDead);
+    if (enDepFoil > 0) FillH1Hist(3, enDepFoil);
+    if (enDepCarrier > 0) FillH1Hist(4, enDepCarrier);
+    if (enDepSourceHolder > 0) FillH1Hist(5, enDepSourceHolder);
+    if (bremsstrahlungLoss > 0) FillH1Hist(6, bremsstrahlungLoss);
+    if (timeSi > 0) FillH1Hist(7, timeSi);
+    if (enDepBacking > 0) FillH1Hist(8, enDepBacking);
+  }
 
-  if (enDepSi > 0) FillH1Hist(1, enDepSi);
-  if (enDepDead > 0) FillH1Hist(2, enDepDead);
-  if (enDepFoil > 0) FillH1Hist(3, enDepFoil);
-  if (enDepCarrier > 0) FillH1Hist(4, enDepCarrier);
-  if (enDepSourceHolder > 0) FillH1Hist(5, enDepSourceHolder);
-  if (bremsstrahlungLoss > 0) FillH1Hist(6, bremsstrahlungLoss);
-  if (timeSi > 0) FillH1Hist(7, timeSi);
+  FillPixelSpectra(pixelEnDep);
+
+  // the ntuples only get the events selected by /NDD/filter/
+  G4double weight = 1.;
+  if (SelectEvent(pixelEnDep, weight)) {
+    G4int iD = evt->GetEventID();
+
+    if (runAction->IsNtupleEnabled(kHitsNtuple)) {
+      if (runAction->GetHitsColumns().perEvent) {
+        FillEventHitsTuple(iD, classification, enPrimary, SiPixelHC);
+      } else {
+        for (G4int iHit = 0; iHit < nrHits; iHit++) {
+          FillHitsTuple(iD, classification, enPrimary, (*SiPixelHC)[iHit]);
+        }
+      }
+    }
 
-  FillEnergyTuple(
-      evt->GetEventID(), classification, enPrimary, enDepSi,
-      enDepDead, enDepFoil, enDepCarrier, enDepSourceHolder,
-      bremsstrahlungLoss);
+    FillSpacetimeTuple(iD, classification, angleSourceOut, angleSiOut, timeSi,
+                       poeXSi, poeYSi);
 
-  for (G4int i = 0; i < pixelEnDep.size(); i++) {
-    if (pixelEnDep[i] > 0) {
-      FillH1Hist(8 + i, pixelEnDep[i]);
+    FillEnergyTuple(iD, classification, enPrimary, enDepSi, enDepDead,
+                    enDepFoil, enDepCarrier, enDepSourceHolder,
+                    bremsstrahlungLoss, enDepBacking, 0, weight);
+
+    FillPixelTuple(iD, classification, enPrimary, pixelEnDep);
+
+    if (nrHits > 0 && runAction->IsNtupleEnabled(kClustersNtuple)) {
+      FillClustersTuple(iD, classification, clusterer.Cluster(SiPixelHC));
+    }
+
+    // the trigger uses the waveform amplitudes when there are any
+    const std::vector<NDDPixelWaveform>* waveforms = nullptr;
+    if (nrHits > 0 && NDDDigitizer::IsEnabled() &&
+        (runAction->IsNtupleEnabled(kWaveformsNtuple) ||
+         runAction->IsNtupleEnabled(kTriggerNtuple))) {
+      waveforms = &digitizer.Digitize(SiPixelHC);
+    }
+
+    if (waveforms && runAction->IsNtupleEnabled(kWaveformsNtuple)) {
+      FillWaveformsTuple(iD, *waveforms);
+    }
+
+    if (nrHits > 0 && runAction->IsNtupleEnabled(kTriggerNtuple)) {
+      FillTriggerTuple(iD, trigger.Process(SiPixelHC, shared, waveforms,
+                                           digitizer.GetStartTime()));
+    }
+
+    if (nrHits > 0 && hitStream->IsOpen()) hitStream->Publish(iD, SiPixelHC);
+
+    if (runAction->IsNtupleEnabled(kVolumesNtuple)) {
+      for (G4int i = 0; i < visitedVolumes.size(); i++) {
+        VolumeVisit* v = &(visitedVolumes[i]);
+        FillVolumesTuple(iD, classification, enPrimary, v->currentEn, v->time,
+                         v->volume);
+      }
     }
   }
 
-  FillPixelTuple(evt->GetEventID(), classification, enPrimary,
-                           pixelEnDep);
+  CheckPrecision(pixelEnDep);
 
-  for (G4int i = 0; i < visitedVolumes.size(); i++) {
-    VolumeVisit* v = &(visitedVolumes[i]);
-    FillVolumesTuple(evt->GetEventID(), classification, enPrimary,
-                               v->currentEn, v->time, v->volume);
+  if (NDDProfiler::IsEnabled()) profiler->EndEvent();
+}
+
+void NDDEventAction::EndOfSurrogateEvent(
+    G4int iD, const NDDSurrogateEventInformation* info) {
+  // Same rows as a transported event, minus anything that needs steps: there
+  // are no hits or visited volumes, and timing/position stay at zero.
+  const NDDResponseSample& sample = info->GetSample();
+  enPrimary = info->GetPrimaryEnergy();
+  enDepSi = sample.enDepSi;
+
+  std::vector<G4double> pixelEnDep;
+  pixelEnDep.resize(NDDPixelMap::Instance()->GetNumberOfPixels());
+  if (sample.pixelNumber > 0 && sample.pixelNumber <= pixelEnDep.size()) {
+    pixelEnDep[sample.pixelNumber - 1] = sample.enDepSi;
+  }
+
+  classification = 1e3 * (enDepSi > 0 ? 1 : 0) +
+                   1e2 * (sample.backscatter ? 1 : 0);
+
+  if (enDepSi > 0 && runAction->GeneralHistogramsEnabled()) {
+    FillH1Hist(1, enDepSi);
+  }
+
+  FillPixelSpectra(pixelEnDep);
+
+  G4double weight = 1.;
+  if (SelectEvent(pixelEnDep, weight)) {
+    FillSpacetimeTuple(iD, classification, angleSourceOut, angleSiOut, timeSi,
+                       poeXSi, poeYSi);
+
+    FillEnergyTuple(iD, classification, enPrimary, enDepSi, enDepDead,
+                    enDepFoil, enDepCarrier, enDepSourceHolder,
+                    bremsstrahlungLoss, enDepBacking, 1, weight);
+
+    FillPixelTuple(iD, classification, enPrimary, pixelEnDep);
+  }
+
+  CheckPrecision(pixelEnDep);
+}
+
+G4bool NDDEventAction::SelectEvent(const std::vector<G4double>& pixelEnDep,
+                                   G4double& weight) {
+  NDDEventFilter* filter = NDDEventFilter::Instance();
+  if (!filter->IsActive()) return true;
+
+  NDDEventFilter::Decision decision =
+      filter->Select(enDepSi, classification, pixelEnDep);
+  weight = filter->GetWeight(decision);
+  return decision != NDDEventFilter::kRejected;
+}
+
+void NDDEventAction::CheckPrecision(const std::vector<G4double>& pixelEnDep) {
+  NDDPrecisionMonitor* monitor = NDDPrecisionMonitor::Instance();
+  if (!monitor->IsActive()) return;
+
+  G4bool backscatter = (classification / 100) % 10 > 0;
+  monitor->RecordEvent(enDepSi, backscatter, pixelEnDep);
+
+  // Soft abort: every worker finishes its current event and stops asking
+  // the master for more.
+  if (monitor->IsConverged()) {
+    G4RunManager::GetRunManager()->AbortRun(true);
+  }
+}
+
+void NDDEventAction::CollectPassiveDeposits() {
+  NDDPassiveSD* sds[] = {deadSD, backingSD, foilSD, carrierSD, sourceHolderSD};
+  G4double* deposits[] = {&enDepDead, &enDepBacking, &enDepFoil,
+                          &enDepCarrier, &enDepSourceHolder};
+  for (G4int i = 0; i < 5; i++) {
+    if (!sds[i]) continue;
+    *deposits[i] += sds[i]->GetEnergyDeposit();
+    bremsstrahlungLoss += sds[i]->GetBremsstrahlungLoss();
   }
 }
 
@@ -122,7 +298,7 @@ void NDDEventAction::AddVisitedVolume(G4double currentEn, G4double time,
 
 void NDDEventAction::Clear() {
   enPrimary = enDepSi = enDepDead = enDepFoil = enDepCarrier =
-          enDepSourceHolder = bremsstrahlungLoss = 0;
+          enDepSourceHolder = enDepBacking = bremsstrahlungLoss = 0;
   poeXSi = poeYSi = timeSi = 0;
   angleSourceOut = angleSiOut= 0;
   visitedVolumes.clear();
@@ -172,90 +348,229 @@ G4int NDDEventAction::ClassifyEvent() {
 void NDDEventAction::FillEnergyTuple(
     G4int iD, G4int classification, G4double enPrimary, G4double enSi,
     G4double enDead, G4double enFoil, G4double enCarrier, G4double enSourceHolder,
-    G4double bremsstrahlungLoss) {
+    G4double bremsstrahlungLoss, G4double enBacking, G4int provenance,
+    G4double weight) {
+  if (!runAction->IsNtupleEnabled(kEnergyNtuple)) return;
 
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
-  if (analysisManager->GetNtupleActivation(0)) {
-    analysisManager->FillNtupleIColumn(0, 0, iD);
-    analysisManager->FillNtupleIColumn(0, 1, classification);
-    analysisManager->FillNtupleDColumn(0, 2, enPrimary / keV);
-    analysisManager->FillNtupleDColumn(0, 3, enSi / keV);
-    analysisManager->FillNtupleDColumn(0, 4, enDead / keV);
-    analysisManager->FillNtupleDColumn(0, 5, enFoil / keV);
-    analysisManager->FillNtupleDColumn(0, 6, enCarrier / keV);
-    analysisManager->FillNtupleDColumn(0, 7, enSourceHolder / keV);
-    analysisManager->FillNtupleDColumn(0, 8, bremsstrahlungLoss / keV);
-    analysisManager->AddNtupleRow(0);
-  }
+  analysisManager->FillNtupleIColumn(kEnergyNtuple, 0, iD);
+  analysisManager->FillNtupleIColumn(kEnergyNtuple, 1, classification);
+  analysisManager->FillNtupleDColumn(kEnergyNtuple, 2, enPrimary / keV);
+  analysisManager->FillNtupleDColumn(kEnergyNtuple, 3, enSi / keV);
+  analysisManager->FillNtupleDColumn(kEnergyNtuple, 4, enDead / keV);
+  analysisManager->FillNtupleDColumn(kEnergyNtuple, 5, enFoil / keV);
+  analysisManager->FillNtupleDColumn(kEnergyNtuple, 6, enCarrier / keV);
+  analysisManager->FillNtupleDColumn(kEnergyNtuple, 7, enSourceHolder / keV);
+  analysisManager->FillNtupleDColumn(kEnergyNtuple, 8, bremsstrahlungLoss / keV);
+  analysisManager->FillNtupleIColumn(kEnergyNtuple, 9, provenance);
+  analysisManager->FillNtupleDColumn(kEnergyNtuple, 10, weight);
+  analysisManager->FillNtupleDColumn(kEnergyNtuple, 11, enBacking / keV);
+  analysisManager->AddNtupleRow(kEnergyNtuple);
 }
 
 void NDDEventAction::FillSpacetimeTuple(
     G4int iD, G4int classification, G4double angleSourceOut,
     G4double angleSiOut, G4double timeSi, G4double poeXSi, G4double poeYSi) {
+  if (!runAction->IsNtupleEnabled(kSpaceTimeNtuple)) return;
+
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
-  if (analysisManager->GetNtupleActivation(1)) {
-    analysisManager->FillNtupleIColumn(1, 0, iD);
-    analysisManager->FillNtupleIColumn(1, 1, classification);
-    analysisManager->FillNtupleDColumn(1, 2, angleSourceOut);
-    analysisManager->FillNtupleDColumn(1, 3, angleSiOut);
-    analysisManager->FillNtupleDColumn(1, 4, timeSi / ns);
-    analysisManager->FillNtupleDColumn(1, 5, poeXSi / mm);
-    analysisManager->FillNtupleDColumn(1, 6, poeYSi / mm);
-    analysisManager->AddNtupleRow(1);
-  }
+  analysisManager->FillNtupleIColumn(kSpaceTimeNtuple, 0, iD);
+  analysisManager->FillNtupleIColumn(kSpaceTimeNtuple, 1, classification);
+  analysisManager->FillNtupleDColumn(kSpaceTimeNtuple, 2, angleSourceOut);
+  analysisManager->FillNtupleDColumn(kSpaceTimeNtuple, 3, angleSiOut);
+  analysisManager->FillNtupleDColumn(kSpaceTimeNtuple, 4, timeSi / ns);
+  analysisManager->FillNtupleDColumn(kSpaceTimeNtuple, 5, poeXSi / mm);
+  analysisManager->FillNtupleDColumn(kSpaceTimeNtuple, 6, poeYSi / mm);
+  analysisManager->AddNtupleRow(kSpaceTimeNtuple);
 }
 
 void NDDEventAction::FillHitsTuple(G4int iD, G4int classification,
-                                   G4double enPrimary, G4double eDep,
-                                   G4double x, G4double y, G4double z,
-                                   G4double px, G4double py, G4double pz,
-                                   G4double time, G4int volume, G4int particle) {
+                                   G4double enPrimary,
+                                   const NDDSiPixelHit* hit) {
+  // columns outside the selected column set have id -1
+  const NDDHitsColumns& c = runAction->GetHitsColumns();
+  G4ThreeVector pos = hit->GetPos();
+  G4ThreeVector mom = hit->GetMomentum();
+
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
-  if (analysisManager->GetNtupleActivation(2)) {
-    analysisManager->FillNtupleIColumn(2, 0, iD);
-    analysisManager->FillNtupleIColumn(2, 1, classification);
-    analysisManager->FillNtupleDColumn(2, 2, enPrimary / keV);
-    analysisManager->FillNtupleDColumn(2, 3, eDep / keV);
-    analysisManager->FillNtupleDColumn(2, 4, x / mm);
-    analysisManager->FillNtupleDColumn(2, 5, y / mm);
-    analysisManager->FillNtupleDColumn(2, 6, z / mm);
-    analysisManager->FillNtupleDColumn(2, 7, px);
-    analysisManager->FillNtupleDColumn(2, 8, py);
-    analysisManager->FillNtupleDColumn(2, 9, pz);
-    analysisManager->FillNtupleDColumn(2, 10, time / ns);
-    analysisManager->FillNtupleIColumn(2, 11, volume);
-    analysisManager->FillNtupleIColumn(2, 12, particle);
-    analysisManager->AddNtupleRow(2);
+  auto fillReal = [&](G4int column, G4double value, G4double quantum) {
+    if (c.precision == kHitsDouble) {
+      analysisManager->FillNtupleDColumn(kHitsNtuple, column, value);
+    } else if (c.precision == kHitsQuantized && quantum > 0) {
+      analysisManager->FillNtupleIColumn(kHitsNtuple, column,
+                                         (G4int)std::lround(value / quantum));
+    } else {
+      analysisManager->FillNtupleFColumn(kHitsNtuple, column, value);
+    }
+  };
+
+  analysisManager->FillNtupleIColumn(kHitsNtuple, c.iD, iD);
+  if (c.classification >= 0) {
+    analysisManager->FillNtupleIColumn(kHitsNtuple, c.classification,
+                                       classification);
+    fillReal(c.enPrimary, enPrimary / keV, hitsEnergyQuantum / keV);
+  }
+  fillReal(c.eDep, hit->GetEnDep() / keV, hitsEnergyQuantum / keV);
+  fillReal(c.x, pos.x() / mm, hitsPositionQuantum / mm);
+  fillReal(c.y, pos.y() / mm, hitsPositionQuantum / mm);
+  fillReal(c.z, pos.z() / mm, hitsPositionQuantum / mm);
+  if (c.px >= 0) {
+    fillReal(c.px, mom.x(), 0.);
+    fillReal(c.py, mom.y(), 0.);
+    fillReal(c.pz, mom.z(), 0.);
   }
+  if (c.time >= 0) {
+    fillReal(c.time, hit->GetTime() / ns, 0.);
+    analysisManager->FillNtupleIColumn(kHitsNtuple, c.particle,
+                                       hit->GetParticleCode());
+  }
+  analysisManager->FillNtupleIColumn(kHitsNtuple, c.pixelNumber,
+                                     hit->GetPixelNumber());
+  analysisManager->FillNtupleIColumn(kHitsNtuple, c.detector,
+                                     hit->GetDetector());
+  analysisManager->AddNtupleRow(kHitsNtuple);
+}
+
+void NDDEventAction::FillEventHitsTuple(G4int iD, G4int classification,
+                                        G4double enPrimary,
+                                        NDDSiPixelHitsCollection* hc) {
+  const NDDHitsColumns& c = runAction->GetHitsColumns();
+  NDDEventHits& v = runAction->GetEventHits();
+  v.Clear();
+
+  G4int nrHits = hc->entries();
+  for (G4int iHit = 0; iHit < nrHits; iHit++) {
+    const NDDSiPixelHit* hit = (*hc)[iHit];
+    G4ThreeVector pos = hit->GetPos();
+    v.eDep.Push(c.precision, hit->GetEnDep() / keV, hitsEnergyQuantum / keV);
+    v.x.Push(c.precision, pos.x() / mm, hitsPositionQuantum / mm);
+    v.y.Push(c.precision, pos.y() / mm, hitsPositionQuantum / mm);
+    v.z.Push(c.precision, pos.z() / mm, hitsPositionQuantum / mm);
+    if (c.px >= 0) {
+      G4ThreeVector mom = hit->GetMomentum();
+      v.px.Push(c.precision, mom.x(), 0.);
+      v.py.Push(c.precision, mom.y(), 0.);
+      v.pz.Push(c.precision, mom.z(), 0.);
+    }
+    if (c.time >= 0) {
+      v.time.Push(c.precision, hit->GetTime() / ns, 0.);
+      v.particle.push_back(hit->GetParticleCode());
+    }
+    v.pixelNumber.push_back(hit->GetPixelNumber());
+    v.detector.push_back(hit->GetDetector());
+  }
+
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  analysisManager->FillNtupleIColumn(kHitsNtuple, c.iD, iD);
+  if (c.classification >= 0) {
+    analysisManager->FillNtupleIColumn(kHitsNtuple, c.classification,
+                                       classification);
+    if (c.precision == kHitsDouble) {
+      analysisManager->FillNtupleDColumn(kHitsNtuple, c.enPrimary,
+                                         enPrimary / keV);
+    } else if (c.precision == kHitsQuantized) {
+      analysisManager->FillNtupleIColumn(
+          kHitsNtuple, c.enPrimary,
+          (G4int)std::lround(enPrimary / hitsEnergyQuantum));
+    } else {
+      analysisManager->FillNtupleFColumn(kHitsNtuple, c.enPrimary,
+                                         enPrimary / keV);
+    }
+  }
+  analysisManager->FillNtupleIColumn(kHitsNtuple, c.nHits, nrHits);
+  analysisManager->AddNtupleRow(kHitsNtuple);
 }
 
 void NDDEventAction::FillPixelTuple(G4int iD, G4int classification,
                                     G4double enPrimary,
                                     std::vector<G4double>& eDep) {
+  if (!runAction->IsNtupleEnabled(kPixelNtuple)) return;
+
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
-  if (analysisManager->GetNtupleActivation(3)) {
-    analysisManager->FillNtupleIColumn(3, 0, iD);
-    analysisManager->FillNtupleIColumn(3, 1, classification);
-    analysisManager->FillNtupleDColumn(3, 2, enPrimary);
-    for (G4int i = 0; i < eDep.size(); i++) {
-      analysisManager->FillNtupleDColumn(3, i + 3, eDep[i] / keV);
-    }
-    analysisManager->AddNtupleRow(3);
+  analysisManager->FillNtupleIColumn(kPixelNtuple, 0, iD);
+  analysisManager->FillNtupleIColumn(kPixelNtuple, 1, classification);
+  analysisManager->FillNtupleDColumn(kPixelNtuple, 2, enPrimary);
+  G4int n = std::min((G4int)eDep.size(), runAction->GetNumberOfPixelColumns());
+  for (G4int i = 0; i < n; i++) {
+    analysisManager->FillNtupleDColumn(kPixelNtuple, i + 3, eDep[i] / keV);
   }
+  analysisManager->AddNtupleRow(kPixelNtuple);
 }
 
 void NDDEventAction::FillVolumesTuple(G4int iD, G4int classification,
                                       G4double primaryEn, G4double currentEn,
                                       G4double time, G4String volume) {
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
-  if (analysisManager->GetNtupleActivation(4)) {
-    analysisManager->FillNtupleIColumn(4, 0, iD);
-    analysisManager->FillNtupleIColumn(4, 1, classification);
-    analysisManager->FillNtupleDColumn(4, 2, primaryEn / keV);
-    analysisManager->FillNtupleDColumn(4, 3, currentEn / keV);
-    analysisManager->FillNtupleDColumn(4, 4, time / ns);
-    analysisManager->FillNtupleSColumn(4, 5, volume);
-    analysisManager->AddNtupleRow(4);
+  analysisManager->FillNtupleIColumn(kVolumesNtuple, 0, iD);
+  analysisManager->FillNtupleIColumn(kVolumesNtuple, 1, classification);
+  analysisManager->FillNtupleDColumn(kVolumesNtuple, 2, primaryEn / keV);
+  analysisManager->FillNtupleDColumn(kVolumesNtuple, 3, currentEn / keV);
+  analysisManager->FillNtupleDColumn(kVolumesNtuple, 4, time / ns);
+  analysisManager->FillNtupleSColumn(kVolumesNtuple, 5, volume);
+  analysisManager->AddNtupleRow(kVolumesNtuple);
+}
+
+void NDDEventAction::FillClustersTuple(
+    G4int iD, G4int classification,
+    const std::vector<NDDHitCluster>& clusters) {
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  for (const NDDHitCluster& c : clusters) {
+    analysisManager->FillNtupleIColumn(kClustersNtuple, 0, iD);
+    analysisManager->FillNtupleIColumn(kClustersNtuple, 1, classification);
+    analysisManager->FillNtupleIColumn(kClustersNtuple, 2, c.nHits);
+    analysisManager->FillNtupleDColumn(kClustersNtuple, 3, c.eDep / keV);
+    analysisManager->FillNtupleDColumn(kClustersNtuple, 4, c.pos.x() / mm);
+    analysisManager->FillNtupleDColumn(kClustersNtuple, 5, c.pos.y() / mm);
+    analysisManager->FillNtupleDColumn(kClustersNtuple, 6, c.pos.z() / mm);
+    analysisManager->FillNtupleDColumn(kClustersNtuple, 7, c.time / ns);
+    analysisManager->FillNtupleIColumn(kClustersNtuple, 8, c.pixelNumber);
+    analysisManager->AddNtupleRow(kClustersNtuple);
+  }
+}
+
+void NDDEventAction::FillWaveformsTuple(
+    G4int iD, const std::vector<NDDPixelWaveform>& waveforms) {
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  std::vector<G4double>& samples = runAction->GetWaveformSamples();
+  for (const NDDPixelWaveform& w : waveforms) {
+    samples = w.samples;
+    analysisManager->FillNtupleIColumn(kWaveformsNtuple, 0, iD);
+    analysisManager->FillNtupleIColumn(kWaveformsNtuple, 1, w.pixelNumber);
+    analysisManager->FillNtupleDColumn(kWaveformsNtuple, 2,
+                                       digitizer.GetStartTime() / ns);
+    analysisManager->FillNtupleDColumn(kWaveformsNtuple, 3,
+                                       NDDDigitizer::GetSamplePeriod() / ns);
+    analysisManager->FillNtupleDColumn(kWaveformsNtuple, 4, w.features.amplitude);
+    analysisManager->FillNtupleDColumn(kWaveformsNtuple, 5, w.features.time / ns);
+    analysisManager->FillNtupleDColumn(kWaveformsNtuple, 6,
+                                       w.features.peakTime / ns);
+    analysisManager->FillNtupleDColumn(kWaveformsNtuple, 7,
+                                       w.features.riseTime / ns);
+    analysisManager->AddNtupleRow(kWaveformsNtuple);
+  }
+}
+
+void NDDEventAction::FillTriggerTuple(
+    G4int iD, const std::vector<NDDTriggerRecord>& records) {
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  for (const NDDTriggerRecord& r : records) {
+    analysisManager->FillNtupleIColumn(kTriggerNtuple, 0, iD);
+    analysisManager->FillNtupleIColumn(kTriggerNtuple, 1, r.pixelNumber);
+    analysisManager->FillNtupleDColumn(kTriggerNtuple, 2, r.energy / keV);
+    analysisManager->FillNtupleDColumn(kTriggerNtuple, 3, r.time / ns);
+    analysisManager->FillNtupleIColumn(kTriggerNtuple, 4, r.selfTriggered);
+    analysisManager->AddNtupleRow(kTriggerNtuple);
+  }
+}
+
+void NDDEventAction::FillPixelSpectra(const std::vector<G4double>& pixelEnDep) {
+  if (!runAction->PixelHistogramsEnabled()) return;
+
+  NDDPixelSpectra* pixelSpectra = runAction->GetPixelSpectra();
+  for (G4int i = 0; i < pixelEnDep.size(); i++) {
+    if (pixelEnDep[i] > 0) {
+      pixelSpectra->Fill(i + 1, pixelEnDep[i]);
+    }
   }
 }
 
@@ -0,0 +1,148 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDEventFilter.hh"
+#include "NDDEventFilterMessenger.hh"
+#include "NDDAnalysis.hh"
+
+#include "G4ios.hh"
+
+namespace {
+const char* classificationFields[4] = {"foilHits", "deadHits", "backscatters",
+                                       "siHits"};
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDEventFilterMessenger* NDDEventFilter::messenger = nullptr;
+
+NDDEventFilter* NDDEventFilter::Instance() {
+  static NDDEventFilter instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDEventFilter::CreateMessenger() {
+  if (!messenger) messenger = new NDDEventFilterMessenger();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDEventFilter::DeleteMessenger() {
+  delete messenger;
+  messenger = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDEventFilter::NDDEventFilter()
+    : nEvents(0), nAccepted(0), nRejected(0), nPrescaled(0) {
+  Clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDEventFilter::Clear() {
+  minEnSi = 0.;
+  minPixels = 0;
+  for (G4int i = 0; i < 4; i++) minDigits[i] = 0;
+  prescale = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDEventFilter::SetMinClassification(const G4String& field, G4int min) {
+  if (field == "backscatters" && min > 0) {
+    G4cout << "ERROR: cannot require backscatters, the event classification "
+              "does not count them yet"
+           << G4endl;
+    return;
+  }
+  for (G4int i = 0; i < 4; i++) {
+    if (field == classificationFields[i]) {
+      minDigits[i] = min;
+      return;
+    }
+  }
+  G4cout << "ERROR: unknown classification field " << field << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDEventFilter::IsActive() const {
+  if (minEnSi > 0 || minPixels > 0) return true;
+  for (G4int i = 0; i < 4; i++) {
+    if (minDigits[i] > 0) return true;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDEventFilter::Reset() {
+  nEvents = 0;
+  nAccepted = 0;
+  nRejected = 0;
+  nPrescaled = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDEventFilter::Decision NDDEventFilter::Select(
+    G4double enDepSi, G4int classification,
+    const std::vector<G4double>& pixelEnDep) {
+  nEvents++;
+
+  G4bool pass = minEnSi <= 0 || enDepSi > minEnSi;
+  for (G4int i = 0; pass && i < 4; i++) {
+    G4int digit = classification % 10;
+    classification /= 10;
+    pass = digit >= minDigits[i];
+  }
+  if (pass && minPixels > 0) {
+    G4int nPixels = 0;
+    for (size_t i = 0; i < pixelEnDep.size(); i++) {
+      if (pixelEnDep[i] > 0) nPixels++;
+    }
+    pass = nPixels >= minPixels;
+  }
+
+  if (pass) {
+    nAccepted++;
+    return kAccepted;
+  }
+  // keep every prescale-th rejected event, counted over all threads
+  G4long n = nRejected++;
+  if (prescale > 0 && n % prescale == 0) {
+    nPrescaled++;
+    return kPrescaled;
+  }
+  return kRejected;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDEventFilter::Report() const {
+  if (!IsActive()) return;
+
+  G4cout << "Event filter: " << nAccepted << " of " << nEvents
+         << " events accepted, " << nPrescaled << " of " << nRejected
+         << " rejected events kept with prescale " << prescale << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDEventFilter::FillHistogram(G4int ih) const {
+  if (!IsActive()) return;
+
+  // bin contents: all events, accepted, rejected, prescaled, prescale factor
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  analysisManager->FillH1(ih, 0.5, nEvents);
+  analysisManager->FillH1(ih, 1.5, nAccepted);
+  analysisManager->FillH1(ih, 2.5, nRejected);
+  analysisManager->FillH1(ih, 3.5, nPrescaled);
+  analysisManager->FillH1(ih, 4.5, prescale);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,114 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDEventFilterMessenger.hh"
+#include "NDDEventFilter.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDEventFilterMessenger::NDDEventFilterMessenger()
+    : G4UImessenger(),
+      filterDir(0),
+      filterMinEnSiCmd(0),
+      filterMinPixelsCmd(0),
+      filterRequireCmd(0),
+      filterPrescaleCmd(0),
+      filterClearCmd(0) {
+  // The event filter is shared by all threads, so these are applied once on
+  // the master rather than broadcast to every worker.
+  filterDir = new G4UIdirectory("/NDD/filter/");
+  filterDir->SetGuidance("Event selection for the ntuple output.");
+  filterDir->SetGuidance("Histograms and pixel spectra see every event.");
+
+  filterMinEnSiCmd = new G4UIcmdWithADoubleAndUnit("/NDD/filter/minEnSi", this);
+  filterMinEnSiCmd->SetGuidance("Keep events with more Si energy than this.");
+  filterMinEnSiCmd->SetParameterName("energy", false);
+  filterMinEnSiCmd->SetRange("energy>=0.");
+  filterMinEnSiCmd->SetUnitCategory("Energy");
+  filterMinEnSiCmd->SetDefaultUnit("keV");
+  filterMinEnSiCmd->SetToBeBroadcasted(false);
+  filterMinEnSiCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  filterMinPixelsCmd = new G4UIcmdWithAnInteger("/NDD/filter/minPixels", this);
+  filterMinPixelsCmd->SetGuidance("Keep events with at least this many pixels hit.");
+  filterMinPixelsCmd->SetParameterName("pixels", false);
+  filterMinPixelsCmd->SetRange("pixels>=0");
+  filterMinPixelsCmd->SetToBeBroadcasted(false);
+  filterMinPixelsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  filterRequireCmd = new G4UIcommand("/NDD/filter/require", this);
+  filterRequireCmd->SetGuidance(
+      "Keep events with at least this count in a classification digit.");
+  filterRequireCmd->SetGuidance(
+      "backscatters cannot be required, they are not classified yet.");
+  G4UIparameter* fieldParam = new G4UIparameter("field", 's', false);
+  fieldParam->SetParameterCandidates("siHits backscatters deadHits foilHits");
+  filterRequireCmd->SetParameter(fieldParam);
+  G4UIparameter* minParam = new G4UIparameter("min", 'i', false);
+  minParam->SetParameterRange("min>=0 && min<=9");
+  filterRequireCmd->SetParameter(minParam);
+  filterRequireCmd->SetToBeBroadcasted(false);
+  filterRequireCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  filterPrescaleCmd = new G4UIcmdWithAnInteger("/NDD/filter/prescale", this);
+  filterPrescaleCmd->SetGuidance(
+      "Keep one in this many rejected events, with this weight; 0 drops all.");
+  filterPrescaleCmd->SetParameterName("prescale", false);
+  filterPrescaleCmd->SetRange("prescale>=0");
+  filterPrescaleCmd->SetToBeBroadcasted(false);
+  filterPrescaleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  filterClearCmd = new G4UIcmdWithoutParameter("/NDD/filter/clear", this);
+  filterClearCmd->SetGuidance("Remove all criteria, every event is written.");
+  filterClearCmd->SetToBeBroadcasted(false);
+  filterClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDEventFilterMessenger::~NDDEventFilterMessenger() {
+  delete filterMinEnSiCmd;
+  delete filterMinPixelsCmd;
+  delete filterRequireCmd;
+  delete filterPrescaleCmd;
+  delete filterClearCmd;
+  delete filterDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDEventFilterMessenger::SetNewValue(G4UIcommand* command,
+                                          G4String newValues) {
+  if (command == filterMinEnSiCmd)
+    NDDEventFilter::Instance()->SetMinEnSi(
+        filterMinEnSiCmd->GetNewDoubleValue(newValues));
+
+  if (command == filterMinPixelsCmd)
+    NDDEventFilter::Instance()->SetMinPixels(
+        filterMinPixelsCmd->GetNewIntValue(newValues));
+
+  if (command == filterRequireCmd) {
+    G4String field;
+    G4int min;
+    std::istringstream is(newValues);
+    is >> field >> min;
+    NDDEventFilter::Instance()->SetMinClassification(field, min);
+  }
+
+  if (command == filterPrescaleCmd)
+    NDDEventFilter::Instance()->SetPrescale(
+        filterPrescaleCmd->GetNewIntValue(newValues));
+
+  if (command == filterClearCmd) NDDEventFilter::Instance()->Clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
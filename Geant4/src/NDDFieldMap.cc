@@ -0,0 +1,190 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDFieldMap.hh"
+
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace {
+G4Mutex fieldMapMutex = G4MUTEX_INITIALIZER;
+std::map<std::pair<G4String, G4double>, NDDFieldMap*> loadedFieldMaps;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const NDDFieldMap* NDDFieldMap::Load(const G4String& filename,
+                                     G4double unit) {
+  G4AutoLock lock(&fieldMapMutex);
+
+  auto key = std::make_pair(filename, unit);
+  auto it = loadedFieldMaps.find(key);
+  if (it != loadedFieldMaps.end()) return it->second;
+
+  NDDFieldMap* map = new NDDFieldMap(filename);
+  if (!map->Read(unit)) {
+    delete map;
+    return nullptr;
+  }
+  loadedFieldMaps[key] = map;
+  return map;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDFieldMap::NDDFieldMap(const G4String& fn) : filename(fn), dimension(0) {
+  for (G4int a = 0; a < 3; a++) {
+    n[a] = 0;
+    min[a] = step[a] = 0.;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDFieldMap::Read(G4double unit) {
+  std::ifstream in(filename, std::ios::binary);
+  if (!in) {
+    G4cout << "ERROR: cannot open field map " << filename << G4endl;
+    return false;
+  }
+
+  char magic[8];
+  int32_t header[4];
+  G4double first[3], last[3];
+  in.read(magic, sizeof(magic));
+  in.read((char*)header, sizeof(header));
+  in.read((char*)first, sizeof(first));
+  in.read((char*)last, sizeof(last));
+  if (!in || std::memcmp(magic, "NDDFMAP1", 8) != 0) {
+    G4cout << "ERROR: " << filename << " is not an NDD field map" << G4endl;
+    return false;
+  }
+
+  dimension = header[0];
+  G4bool good = dimension == 2 || dimension == 3;
+  for (G4int a = 0; a < 3; a++) {
+    n[a] = header[a + 1];
+    // a single point along an axis only makes sense for y in 2D
+    good = good && (n[a] >= 2 || (a == 1 && n[a] == 1));
+    min[a] = first[a] * mm;
+    step[a] = n[a] > 1 ? (last[a] - first[a]) * mm / (n[a] - 1) : 1.;
+    good = good && step[a] > 0;
+  }
+  if (!good || (dimension == 2) != (n[1] == 1)) {
+    G4cout << "ERROR: bad grid in field map " << filename << G4endl;
+    return false;
+  }
+
+  values.resize((size_t)n[0] * n[1] * n[2] * GetComponents());
+  in.read((char*)&values[0], values.size() * sizeof(G4float));
+  if (!in) {
+    G4cout << "ERROR: field map " << filename << " is too short for its "
+           << n[0] << "x" << n[1] << "x" << n[2] << " grid" << G4endl;
+    return false;
+  }
+  for (G4float& b : values) b *= unit;
+
+  G4cout << "Loaded " << (dimension == 2 ? "axisymmetric " : "")
+         << "field map " << filename << " with " << n[0] << "x"
+         << (dimension == 2 ? "" : std::to_string(n[1]) + "x") << n[2]
+         << " points" << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDFieldMapInterpolator::NDDFieldMapInterpolator(const NDDFieldMap* m,
+                                                 G4double s,
+                                                 const G4ThreeVector& o)
+    : map(m), scale(s), offset(o), cell(-1) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDFieldMapInterpolator::LoadCell(G4int i, G4int j, G4int k) const {
+  G4int components = map->GetComponents();
+  G4int nj = map->GetDimension() == 2 ? 1 : 2;
+  G4int c = 0;
+  for (G4int di = 0; di < 2; di++) {
+    for (G4int dj = 0; dj < nj; dj++) {
+      for (G4int dk = 0; dk < 2; dk++, c++) {
+        const G4float* b = map->GetPoint(i + di, j + dj, k + dk);
+        for (G4int m = 0; m < components; m++) corners[c][m] = b[m] * scale;
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDFieldMapInterpolator::Evaluate(const G4double point[3],
+                                         G4double* value) const {
+  value[0] = value[1] = value[2] = 0.;
+
+  G4double x = point[0] - offset.x();
+  G4double y = point[1] - offset.y();
+  G4double z = point[2] - offset.z();
+  G4bool axisymmetric = map->GetDimension() == 2;
+  G4double r = axisymmetric ? std::sqrt(x * x + y * y) : 0.;
+  G4double u[3] = {axisymmetric ? r : x, axisymmetric ? 0. : y, z};
+
+  // cell and position inside it along each axis
+  G4int index[3] = {0, 0, 0};
+  G4double f[3] = {0., 0., 0.};
+  for (G4int a = 0; a < 3; a++) {
+    if (axisymmetric && a == 1) continue;
+    G4int n = map->GetN(a);
+    G4double s = (u[a] - map->GetMin(a)) / map->GetStep(a);
+    if (!(s >= 0 && s <= n - 1)) return false;
+    index[a] = std::min((G4int)s, n - 2);
+    f[a] = s - index[a];
+  }
+
+  G4long id = ((G4long)index[0] * map->GetN(1) + index[1]) * map->GetN(2) + index[2];
+  if (id != cell) {
+    LoadCell(index[0], index[1], index[2]);
+    cell = id;
+  }
+
+  if (axisymmetric) {
+    G4double w[4] = {(1 - f[0]) * (1 - f[2]), (1 - f[0]) * f[2],
+                     f[0] * (1 - f[2]), f[0] * f[2]};
+    G4double vr = 0., vz = 0.;
+    for (G4int c = 0; c < 4; c++) {
+      vr += w[c] * corners[c][0];
+      vz += w[c] * corners[c][1];
+    }
+    if (r > 0) {
+      value[0] = vr * x / r;
+      value[1] = vr * y / r;
+    }
+    value[2] = vz;
+    return true;
+  }
+
+  G4int c = 0;
+  for (G4int di = 0; di < 2; di++) {
+    G4double wi = di ? f[0] : 1 - f[0];
+    for (G4int dj = 0; dj < 2; dj++) {
+      G4double wj = wi * (dj ? f[1] : 1 - f[1]);
+      for (G4int dk = 0; dk < 2; dk++, c++) {
+        G4double w = wj * (dk ? f[2] : 1 - f[2]);
+        value[0] += w * corners[c][0];
+        value[1] += w * corners[c][1];
+        value[2] += w * corners[c][2];
+      }
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,291 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDGuidingCentreModel.hh"
+
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4Field.hh"
+#include "G4FieldManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Region.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TransportationManager.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+G4bool NDDGuidingCentreModel::enabled = false;
+G4double NDDGuidingCentreModel::maxStep = 5. * cm;
+G4double NDDGuidingCentreModel::adiabaticity = 0.01;
+G4double NDDGuidingCentreModel::margin = 3.;
+G4double NDDGuidingCentreModel::distance = 1. * cm;
+
+namespace {
+G4ThreadLocal NDDGuidingCentreModel* installedModel = nullptr;
+// finite difference for the gradient of |B|, below the spacing of a map
+const G4double gradientStep = 1. * mm;
+// flight over which the mirror point is located
+const G4double mirrorStep = 1. * mm;
+// steps per DoIt, the track is handed back after as many
+const G4int maxSteps = 100000;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDGuidingCentreModel::NDDGuidingCentreModel(G4Region* region)
+    : G4VFastSimulationModel("NDDGuidingCentreModel", region),
+      navigator(new G4Navigator()),
+      field(0),
+      charge(0.),
+      momentum(0.),
+      energy(0.),
+      moment(0.),
+      sign(1.),
+      stalledTrack(-1),
+      stalledTime(-1.) {
+  navigator->SetWorldVolume(G4TransportationManager::GetTransportationManager()
+                                ->GetNavigatorForTracking()
+                                ->GetWorldVolume());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDGuidingCentreModel::~NDDGuidingCentreModel() { delete navigator; }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDGuidingCentreModel::Install() {
+  // the world region and its fast simulation manager outlive a geometry
+  // update, so one model per thread does; it reads the settings live
+  if (!enabled || installedModel) return;
+  G4LogicalVolume* world = G4TransportationManager::GetTransportationManager()
+                               ->GetNavigatorForTracking()
+                               ->GetWorldVolume()
+                               ->GetLogicalVolume();
+  installedModel = new NDDGuidingCentreModel(world->GetRegion());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDGuidingCentreModel::IsApplicable(
+    const G4ParticleDefinition& particle) {
+  return particle.GetPDGCharge() != 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDGuidingCentreModel::Sample(const G4ThreeVector& x, G4double t,
+                                     G4ThreeVector& b) const {
+  const G4double point[4] = {x.x(), x.y(), x.z(), t};
+  G4double value[6] = {0., 0., 0., 0., 0., 0.};
+  field->GetFieldValue(point, value);
+  b.set(value[0], value[1], value[2]);
+  // an electric field changes the energy, which is left to full tracking
+  if (value[3] != 0 || value[4] != 0 || value[5] != 0) return false;
+  return b.mag2() > 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreeVector NDDGuidingCentreModel::Gradient(const G4ThreeVector& x,
+                                              G4double t) const {
+  G4ThreeVector gradient, up, down;
+  for (G4int a = 0; a < 3; a++) {
+    G4ThreeVector h;
+    h[a] = gradientStep;
+    Sample(x + h, t, up);
+    Sample(x - h, t, down);
+    gradient[a] = (up.mag() - down.mag()) / (2. * gradientStep);
+  }
+  return gradient;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDGuidingCentreModel::Velocity(const G4ThreeVector& b,
+                                       const G4ThreeVector& gradient,
+                                       G4ThreeVector& velocity) const {
+  G4double magnitude = b.mag();
+  G4double pPerp2 = moment * magnitude;
+  G4double pPar2 = momentum * momentum - pPerp2;
+  // beyond the mirror point
+  if (pPar2 < 0) return false;
+
+  G4double c = c_light / energy;
+  G4double vPar = sign * std::sqrt(pPar2) * c;
+  G4double vPerp2 = pPerp2 * c * c;
+  G4ThreeVector direction = b / magnitude;
+  // grad-B and curvature drift in a vacuum field
+  G4double cyclotron = charge * c_light * c * magnitude;
+  G4ThreeVector drift = (vPar * vPar + 0.5 * vPerp2) / (cyclotron * magnitude) *
+                        direction.cross(gradient);
+  velocity = vPar * direction + drift;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NDDGuidingCentreModel::Safety(const G4ThreeVector& x) {
+  const G4VPhysicalVolume* volume =
+      navigator->LocateGlobalPointAndSetup(x, nullptr, false, true);
+  if (volume != navigator->GetWorldVolume()) return 0.;
+  return navigator->ComputeSafety(x, DBL_MAX, true);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDGuidingCentreModel::ModelTrigger(const G4FastTrack& fastTrack) {
+  if (!enabled) return false;
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  if (track->GetVolume() != navigator->GetWorldVolume()) return false;
+  if (track->GetTrackID() == stalledTrack &&
+      track->GetGlobalTime() == stalledTime) {
+    return false;
+  }
+  field = G4TransportationManager::GetTransportationManager()
+              ->GetFieldManager()
+              ->GetDetectorField();
+  if (!field) return false;
+
+  G4ThreeVector x = track->GetPosition();
+  G4double t = track->GetGlobalTime();
+  G4ThreeVector b;
+  if (!Sample(x, t, b)) return false;
+
+  // from the guiding centre to the particle
+  G4ThreeVector p = track->GetMomentum();
+  charge = track->GetDynamicParticle()->GetCharge();
+  gyration = b.cross(p) / (charge * c_light * b.mag2());
+  centre = x - gyration;
+  if (!Sample(centre, t, b)) return false;
+
+  G4double magnitude = b.mag();
+  G4double gyroradius = gyration.mag();
+  if (Safety(centre) < HandBack(gyroradius) + distance) return false;
+  if (gyroradius * Gradient(centre, t).mag() > adiabaticity * magnitude) {
+    return false;
+  }
+
+  momentum = p.mag();
+  energy = track->GetTotalEnergy();
+  moment = p.perp2(b) / magnitude;
+  sign = p.dot(b) < 0 ? -1. : 1.;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDGuidingCentreModel::DoIt(const G4FastTrack& fastTrack,
+                                 G4FastStep& fastStep) {
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  G4double speed = c_light * momentum / energy;
+  G4double t0 = track->GetGlobalTime();
+
+  // the gyration phase, relative to a direction perpendicular to B
+  G4ThreeVector x = centre, b, gradient, velocity, v;
+  G4double t = t0;
+  Sample(x, t, b);
+  G4ThreeVector e1 = b.orthogonal().unit();
+  G4ThreeVector e2 = b.unit().cross(e1);
+  G4double phase = std::atan2(gyration.dot(e2), gyration.dot(e1));
+
+  G4int moves = 0, flips = 0;
+  G4bool edge = false;
+  for (G4int n = 0; n < maxSteps && flips < 3; n++) {
+    G4double magnitude = b.mag();
+    G4double gyroradius =
+        std::sqrt(moment * magnitude) / (std::fabs(charge) * c_light * magnitude);
+    gradient = Gradient(x, t);
+    G4double scale = gradient.mag();
+    if (gyroradius * scale > adiabaticity * magnitude) break;
+    G4double room = Safety(x) - HandBack(gyroradius);
+    if (room <= 0) break;
+
+    // within the room left, a tenth of the length over which |B| changes
+    // and, towards a mirror, a tenth of the parallel momentum squared
+    G4double step = std::min(maxStep, room);
+    if (scale > 0) {
+      G4double pPar2 = momentum * momentum - moment * magnitude;
+      G4double mirror = 0.1 * std::sqrt(std::max(pPar2, 0.)) * momentum /
+                        (moment * scale);
+      step = std::min(step, 0.1 * magnitude / scale);
+      step = std::min(step, std::max(mirror, mirrorStep));
+    }
+    G4double dt = step / speed;
+
+    // midpoint rule; a step running into the mirror point is halved until
+    // it stops short of it or is below mirrorStep, then the particle is
+    // reflected where it is
+    G4ThreeVector xMid, bMid, xNew, bNew;
+    G4bool reflect = !Velocity(b, gradient, velocity);
+    while (!reflect) {
+      xMid = x + 0.5 * dt * velocity;
+      if (!Sample(xMid, t + 0.5 * dt, bMid)) {
+        edge = true;
+        break;
+      }
+      if (Velocity(bMid, gradient, v)) {
+        xNew = x + dt * v;
+        if (!Sample(xNew, t + dt, bNew)) {
+          edge = true;
+          break;
+        }
+        G4ThreeVector end;
+        if (Velocity(bNew, gradient, end)) break;
+      }
+      if (dt * speed < mirrorStep) {
+        reflect = true;
+      } else {
+        dt *= 0.5;
+      }
+    }
+    if (edge) break;
+    if (reflect) {
+      sign = -sign;
+      flips++;
+      continue;
+    }
+
+    phase -= charge * c_light * c_light * bMid.mag() / energy * dt;
+    x = xNew;
+    b = bNew;
+    t += dt;
+    moves++;
+    flips = 0;
+  }
+
+  if (moves == 0) {
+    stalledTrack = track->GetTrackID();
+    stalledTime = t0;
+    return;
+  }
+
+  // the particle on its gyration circle around the guiding centre, with
+  // the phase carried over to the perpendicular directions of the new B
+  G4double magnitude = b.mag();
+  G4ThreeVector direction = b / magnitude;
+  G4double pPerp = std::sqrt(moment * magnitude);
+  G4double pPar = sign * std::sqrt(std::max(momentum * momentum - pPerp * pPerp, 0.));
+  e1 = b.orthogonal().unit();
+  e2 = direction.cross(e1);
+  G4ThreeVector radial = std::cos(phase) * e1 + std::sin(phase) * e2;
+  G4ThreeVector position =
+      x + pPerp / (std::fabs(charge) * c_light * magnitude) * radial;
+  G4ThreeVector p = pPar * direction +
+                    (charge > 0 ? pPerp : -pPerp) * radial.cross(direction);
+
+  G4double dt = t - t0;
+  fastStep.ProposePrimaryTrackFinalPosition(position, false);
+  fastStep.ProposePrimaryTrackFinalMomentumDirection(p.unit(), false);
+  fastStep.ProposePrimaryTrackFinalTime(t);
+  fastStep.ProposePrimaryTrackFinalProperTime(
+      track->GetProperTime() + dt * track->GetDynamicParticle()->GetMass() / energy);
+  fastStep.ProposePrimaryTrackPathLength(speed * dt);
+  fastStep.ProposeTotalEnergyDeposited(0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,134 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDHitClusterer.hh"
+#include "NDDHitClustererMessenger.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+G4double NDDHitClusterer::radius = 0.;
+NDDHitClustererMessenger* NDDHitClusterer::messenger = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDHitClusterer::CreateMessenger() {
+  if (!messenger) messenger = new NDDHitClustererMessenger();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDHitClusterer::DeleteMessenger() {
+  delete messenger;
+  messenger = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDHitClusterer::NDDHitClusterer() {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDHitClusterer::CellKey NDDHitClusterer::GetKey(G4long ix, G4long iy,
+                                                 G4long iz) const {
+  // 21 bits per axis is ample: cells are at least micrometres wide and the
+  // detector is centimetres across
+  const G4long mask = (1L << 21) - 1;
+  return ((ix & mask) << 42) | ((iy & mask) << 21) | (iz & mask);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int NDDHitClusterer::Find(G4int i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDHitClusterer::Link(NDDSiPixelHitsCollection* hc, G4int i,
+                           CellKey key) {
+  G4ThreeVector pos = (*hc)[i]->GetPos();
+  auto first = std::lower_bound(grid.begin(), grid.end(),
+                                std::make_pair(key, (G4int)-1));
+  for (auto it = first; it != grid.end() && it->first == key; ++it) {
+    G4int j = it->second;
+    if (j <= i) continue;
+    if ((pos - (*hc)[j]->GetPos()).mag2() < radius * radius) {
+      G4int a = Find(i), b = Find(j);
+      if (a != b) parent[a] = b;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::vector<NDDHitCluster>& NDDHitClusterer::Cluster(
+    NDDSiPixelHitsCollection* hc) {
+  clusters.clear();
+  G4int nHits = hc->entries();
+  if (nHits == 0) return clusters;
+
+  grid.resize(nHits);
+  cellIndex.resize(3 * nHits);
+  parent.resize(nHits);
+  for (G4int i = 0; i < nHits; i++) {
+    parent[i] = i;
+    G4ThreeVector pos = (*hc)[i]->GetPos();
+    cellIndex[3 * i] = (G4long)std::floor(pos.x() / radius);
+    cellIndex[3 * i + 1] = (G4long)std::floor(pos.y() / radius);
+    cellIndex[3 * i + 2] = (G4long)std::floor(pos.z() / radius);
+    grid[i] = std::make_pair(GetKey(cellIndex[3 * i], cellIndex[3 * i + 1], cellIndex[3 * i + 2]), i);
+  }
+  std::sort(grid.begin(), grid.end());
+
+  // link each hit to every later hit within the radius
+  for (G4int i = 0; i < nHits; i++) {
+    for (G4long dx = -1; dx <= 1; dx++) {
+      for (G4long dy = -1; dy <= 1; dy++) {
+        for (G4long dz = -1; dz <= 1; dz++) {
+          Link(hc, i, GetKey(cellIndex[3 * i] + dx, cellIndex[3 * i + 1] + dy,
+                             cellIndex[3 * i + 2] + dz));
+        }
+      }
+    }
+  }
+
+  // sum the hits of each cluster, in the order the clusters first appear
+  clusterOf.assign(nHits, -1);
+  firstHit.clear();
+  maxDep.clear();
+  for (G4int i = 0; i < nHits; i++) {
+    G4int root = Find(i);
+    if (clusterOf[root] < 0) {
+      clusterOf[root] = clusters.size();
+      NDDHitCluster c = {0., G4ThreeVector(), DBL_MAX, 0, 0};
+      clusters.push_back(c);
+      firstHit.push_back(i);
+      maxDep.push_back(-1.);
+    }
+    G4int k = clusterOf[root];
+    const NDDSiPixelHit* hit = (*hc)[i];
+    NDDHitCluster& c = clusters[k];
+    G4double e = hit->GetEnDep();
+    c.eDep += e;
+    c.pos += e * hit->GetPos();
+    c.time = std::min(c.time, hit->GetTime());
+    c.nHits++;
+    if (e > maxDep[k]) {
+      maxDep[k] = e;
+      c.pixelNumber = hit->GetPixelNumber();
+    }
+  }
+  for (size_t k = 0; k < clusters.size(); k++) {
+    NDDHitCluster& c = clusters[k];
+    c.pos = c.eDep > 0 ? c.pos / c.eDep : (*hc)[firstHit[k]]->GetPos();
+  }
+  return clusters;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
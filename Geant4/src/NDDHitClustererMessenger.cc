@@ -0,0 +1,46 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDHitClustererMessenger.hh"
+#include "NDDHitClusterer.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDHitClustererMessenger::NDDHitClustererMessenger()
+    : G4UImessenger(),
+      clusterDir(0),
+      clusterRadiusCmd(0) {
+  clusterDir = new G4UIdirectory("/NDD/cluster/");
+  clusterDir->SetGuidance("Merging of hits into charge clouds.");
+
+  clusterRadiusCmd = new G4UIcmdWithADoubleAndUnit("/NDD/cluster/radius", this);
+  clusterRadiusCmd->SetGuidance(
+      "Merge hits closer than this into one cluster, 0 to disable.");
+  clusterRadiusCmd->SetGuidance("Clusters are written to the clusters ntuple.");
+  clusterRadiusCmd->SetParameterName("radius", false);
+  clusterRadiusCmd->SetRange("radius>=0.");
+  clusterRadiusCmd->SetUnitCategory("Length");
+  clusterRadiusCmd->SetDefaultUnit("mm");
+  clusterRadiusCmd->SetToBeBroadcasted(false);
+  clusterRadiusCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDHitClustererMessenger::~NDDHitClustererMessenger() {
+  delete clusterRadiusCmd;
+  delete clusterDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDHitClustererMessenger::SetNewValue(G4UIcommand* command,
+                                           G4String newValues) {
+  if (command == clusterRadiusCmd)
+    NDDHitClusterer::SetRadius(clusterRadiusCmd->GetNewDoubleValue(newValues));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
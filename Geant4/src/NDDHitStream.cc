@@ -0,0 +1,259 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDHitStream.hh"
+#include "NDDHitStreamMessenger.hh"
+
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define NDD_HAVE_SHM 1
+#endif
+
+namespace {
+G4Mutex streamMutex = G4MUTEX_INITIALIZER;
+
+const uint32_t paddingRecord = 0xFFFFFFFF;
+const uint32_t endOfRunRecord = 0xFFFFFFFE;
+const uint32_t hitSize = 8 * 4;
+const uint64_t recordHeaderSize = 8;
+
+struct StreamHit {
+  float x, y, z, eDep, time;
+  int32_t pixelNumber, detector, reserved;
+};
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDHitStreamMessenger* NDDHitStream::messenger = nullptr;
+
+NDDHitStream* NDDHitStream::Instance() {
+  static NDDHitStream instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDHitStream::CreateMessenger() {
+  if (!messenger) messenger = new NDDHitStreamMessenger();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDHitStream::DeleteMessenger() {
+  delete messenger;
+  messenger = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDHitStream::NDDHitStream()
+    : timeout(-1.),
+      header(nullptr),
+      data(nullptr),
+      mappedSize(0),
+      dropped(0),
+      warnedFull(false) {
+  static_assert(sizeof(Header) == 64, "stream header layout");
+  static_assert(sizeof(StreamHit) == hitSize, "stream hit layout");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDHitStream::~NDDHitStream() { Close(); }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDHitStream::Open(const G4String& n, G4double capacityMB,
+                          G4double t) {
+  Close();
+  if (n.empty() || n == "none") return false;
+
+#ifdef NDD_HAVE_SHM
+  name = n;
+  if (name[0] != '/') name = "/" + name;
+  uint64_t capacity = (uint64_t)(capacityMB * 1024 * 1024);
+  capacity -= capacity % 8;
+  // at least room for an event with one hit
+  if (capacity < recordHeaderSize + hitSize) {
+    G4cout << "ERROR: hits stream capacity of " << capacityMB
+           << " MB is smaller than one record" << G4endl;
+    return false;
+  }
+  size_t size = sizeof(Header) + capacity;
+
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+  if (fd < 0 || ftruncate(fd, size) != 0) {
+    G4cout << "ERROR: cannot create shared memory " << name << G4endl;
+    if (fd >= 0) close(fd);
+    return false;
+  }
+  void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    G4cout << "ERROR: cannot map shared memory " << name << G4endl;
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  header = new (p) Header();
+  std::memcpy(header->magic, "NDDHITS2", 8);
+  header->headerSize = sizeof(Header);
+  header->hitSize = hitSize;
+  header->capacity = capacity;
+  header->writeOffset = 0;
+  header->readOffset = 0;
+  header->finished = 0;
+  header->nEvents = 0;
+  data = (char*)p + sizeof(Header);
+  mappedSize = size;
+  timeout = t;
+  dropped = 0;
+  warnedFull = false;
+
+  G4cout << "Streaming hits to /dev/shm" << name << " (" << capacityMB
+         << " MB)" << G4endl;
+  return true;
+#else
+  G4cout << "ERROR: shared memory streaming is not available on this platform"
+         << G4endl;
+  return false;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDHitStream::Close() {
+#ifdef NDD_HAVE_SHM
+  if (!data) return;
+  // the consumer unlinks the segment once it has drained it
+  header->finished.store(1, std::memory_order_release);
+  munmap(header, mappedSize);
+#endif
+  header = nullptr;
+  data = nullptr;
+  mappedSize = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDHitStream::Publish(G4int eventID, NDDSiPixelHitsCollection* hc) {
+  if (!data) return;
+  // encode outside the lock, only the copy into the ring is serialized
+  uint32_t nHits = hc->entries();
+  std::vector<char> record(recordHeaderSize + nHits * hitSize);
+  char* p = record.data();
+  std::memcpy(p, &nHits, 4);
+  std::memcpy(p + 4, &eventID, 4);
+  p += recordHeaderSize;
+  for (uint32_t i = 0; i < nHits; i++) {
+    const NDDSiPixelHit* hit = (*hc)[i];
+    StreamHit h = {(float)(hit->GetPos().x() / mm),
+                   (float)(hit->GetPos().y() / mm),
+                   (float)(hit->GetPos().z() / mm),
+                   (float)(hit->GetEnDep() / keV),
+                   (float)(hit->GetTime() / ns),
+                   hit->GetPixelNumber(),
+                   hit->GetDetector(),
+                   0};
+    std::memcpy(p, &h, hitSize);
+    p += hitSize;
+  }
+  Write(record, eventID);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDHitStream::EndOfRun() {
+  if (!data) return;
+  std::vector<char> record(recordHeaderSize);
+  int32_t eventID = -1;
+  std::memcpy(record.data(), &endOfRunRecord, 4);
+  std::memcpy(record.data() + 4, &eventID, 4);
+  Write(record, eventID);
+
+  G4AutoLock lock(&streamMutex);
+  if (dropped > 0) {
+    G4cout << "Hits stream " << name << ": " << dropped
+           << " records dropped, the consumer fell behind" << G4endl;
+  }
+  dropped = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDHitStream::Write(const std::vector<char>& record, G4int eventID) {
+  G4bool dropping = timeout >= 0;
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::duration<double, std::milli>(
+                      dropping ? timeout / ms : 0.);
+  while (true) {
+    {
+      G4AutoLock lock(&streamMutex);
+      if (!data) return;
+      if (record.size() > header->capacity) {
+        G4cout << "ERROR: event " << eventID
+               << " does not fit into the hits stream" << G4endl;
+        dropped++;
+        return;
+      }
+      if (TryWrite(record)) return;
+      if (dropping && std::chrono::steady_clock::now() >= deadline) {
+        dropped++;
+        return;
+      }
+      if (!warnedFull) {
+        G4cout << "Hits stream " << name << " is full, waiting for the consumer";
+        if (dropping) G4cout << " up to " << timeout / ms << " ms per event";
+        G4cout << G4endl;
+        warnedFull = true;
+      }
+    }
+    // wait without the lock, other workers keep encoding their events
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDHitStream::TryWrite(const std::vector<char>& record) {
+  uint64_t capacity = header->capacity;
+  uint64_t size = record.size();
+  uint64_t write = header->writeOffset.load(std::memory_order_relaxed);
+  uint64_t start = write % capacity;
+  // records never wrap; pad to the end of the region instead
+  uint64_t padding = start + size > capacity ? capacity - start : 0;
+  if (write + padding + size -
+          header->readOffset.load(std::memory_order_acquire) >
+      capacity) {
+    return false;
+  }
+
+  if (padding > 0) {
+    std::memcpy(data + start, &paddingRecord, 4);
+    write += padding;
+    start = 0;
+  }
+  std::memcpy(data + start, record.data(), size);
+
+  // publish only once the record is complete
+  header->writeOffset.store(write + size, std::memory_order_release);
+  uint32_t nHits;
+  std::memcpy(&nHits, record.data(), 4);
+  if (nHits != endOfRunRecord) header->nEvents++;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,67 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDHitStreamMessenger.hh"
+#include "NDDHitStream.hh"
+
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDHitStreamMessenger::NDDHitStreamMessenger()
+    : G4UImessenger(),
+      streamCmd(0) {
+  // one stream is shared by all threads
+  streamCmd = new G4UIcommand("/NDD/output/stream", this);
+  streamCmd->SetGuidance(
+      "Publish the hits of every written event into a shared-memory ring");
+  streamCmd->SetGuidance(
+      "buffer /dev/shm/<name>, see NDDHitStream.hh for the layout.");
+  streamCmd->SetGuidance(
+      "A full ring blocks the workers until the consumer catches up. With");
+  streamCmd->SetGuidance(
+      "timeoutMs >= 0 an event is dropped instead once the ring stayed full");
+  streamCmd->SetGuidance(
+      "that long (0 drops at once); dropped events are counted at run end.");
+  streamCmd->SetGuidance("Use 'none' to close the stream.");
+  streamCmd->SetParameter(new G4UIparameter("name", 's', false));
+  G4UIparameter* capacityParam = new G4UIparameter("capacityMB", 'd', true);
+  capacityParam->SetDefaultValue(64.);
+  capacityParam->SetParameterRange("capacityMB>0.");
+  streamCmd->SetParameter(capacityParam);
+  G4UIparameter* timeoutParam = new G4UIparameter("timeoutMs", 'd', true);
+  timeoutParam->SetDefaultValue(-1.);
+  streamCmd->SetParameter(timeoutParam);
+  streamCmd->SetToBeBroadcasted(false);
+  streamCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDHitStreamMessenger::~NDDHitStreamMessenger() {
+  delete streamCmd;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDHitStreamMessenger::SetNewValue(G4UIcommand* command,
+                                        G4String newValues) {
+  if (command == streamCmd) {
+    G4String name;
+    G4double capacity, timeout;
+    std::istringstream is(newValues);
+    is >> name >> capacity >> timeout;
+    if (name == "none") {
+      NDDHitStream::Instance()->Close();
+    } else {
+      NDDHitStream::Instance()->Open(name, capacity,
+                                     timeout < 0 ? -1. : timeout * ms);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
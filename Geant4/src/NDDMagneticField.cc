@@ -0,0 +1,120 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDMagneticField.hh"
+#include "NDDElectricField.hh"
+
+#include "G4CashKarpRKF45.hh"
+#include "G4ChordFinder.hh"
+#include "G4ClassicalRK4.hh"
+#include "G4DormandPrince745.hh"
+#include "G4EqMagElectricField.hh"
+#include "G4FieldManager.hh"
+#include "G4MagIntegratorDriver.hh"
+#include "G4Mag_UsualEqRhs.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TransportationManager.hh"
+#include "G4ios.hh"
+
+const NDDFieldMap* NDDMagneticField::fieldMap = nullptr;
+G4double NDDMagneticField::scale = 1.;
+G4ThreeVector NDDMagneticField::offset;
+NDDFieldIntegration NDDMagneticField::integration = {
+    "DormandPrince745", 0.01 * mm, 0.25 * mm, 0.01 * mm, 0.001 * mm, 5e-5, 1e-3};
+
+namespace {
+// what the current thread installed, replaced on the next initialization
+G4ThreadLocal NDDMagneticField* installedMagnetic = nullptr;
+G4ThreadLocal NDDElectricField* installedElectric = nullptr;
+G4ThreadLocal G4EquationOfMotion* installedEquation = nullptr;
+G4ThreadLocal G4MagIntegratorStepper* installedStepper = nullptr;
+G4ThreadLocal G4ChordFinder* installedChordFinder = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDMagneticField::NDDMagneticField(const NDDFieldMap* m, G4double s,
+                                   const G4ThreeVector& o)
+    : G4MagneticField(), interpolator(m, s, o) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDMagneticField::SetMap(const G4String& filename) {
+  if (filename == "none") {
+    fieldMap = nullptr;
+    return true;
+  }
+  const NDDFieldMap* m = NDDFieldMap::Load(filename, tesla);
+  if (!m) return false;
+  fieldMap = m;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDMagneticField::Install() {
+  G4FieldManager* manager =
+      G4TransportationManager::GetTransportationManager()->GetFieldManager();
+  if (!IsEnabled() && !NDDElectricField::IsEnabled()) {
+    manager->SetDetectorField(nullptr);
+    return;
+  }
+
+  // an electric field takes the magnetic one along, and needs the
+  // equation with energy and time among the variables
+  NDDMagneticField* magnetic =
+      IsEnabled() ? new NDDMagneticField(fieldMap, scale, offset) : nullptr;
+  NDDElectricField* electric = nullptr;
+  G4Field* field = magnetic;
+  G4EquationOfMotion* equation;
+  G4int variables = 6;
+  if (NDDElectricField::IsEnabled()) {
+    electric = new NDDElectricField(magnetic);
+    field = electric;
+    equation = new G4EqMagElectricField(electric);
+    variables = 8;
+  } else {
+    equation = new G4Mag_UsualEqRhs(magnetic);
+  }
+
+  G4MagIntegratorStepper* stepper;
+  if (integration.stepper == "ClassicalRK4") {
+    stepper = new G4ClassicalRK4(equation, variables);
+  } else if (integration.stepper == "CashKarpRKF45") {
+    stepper = new G4CashKarpRKF45(equation, variables);
+  } else {
+    stepper = new G4DormandPrince745(equation, variables);
+  }
+  G4MagInt_Driver* driver =
+      new G4MagInt_Driver(integration.minStep, stepper, variables);
+  G4ChordFinder* chordFinder = new G4ChordFinder(driver);
+  chordFinder->SetDeltaChord(integration.deltaChord);
+
+  manager->SetDetectorField(field);
+  manager->SetChordFinder(chordFinder);
+  manager->SetDeltaOneStep(integration.deltaOneStep);
+  manager->SetDeltaIntersection(integration.deltaIntersection);
+  manager->SetMaximumEpsilonStep(integration.epsilonMax);
+  manager->SetMinimumEpsilonStep(integration.epsilonMin);
+
+  // the chord finder deletes its driver, but not the stepper
+  delete installedChordFinder;
+  delete installedStepper;
+  delete installedEquation;
+  delete installedElectric;
+  delete installedMagnetic;
+  installedMagnetic = magnetic;
+  installedElectric = electric;
+  installedEquation = equation;
+  installedStepper = stepper;
+  installedChordFinder = chordFinder;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDMagneticField::GetFieldValue(const G4double point[4],
+                                     G4double* field) const {
+  interpolator.Evaluate(point, field);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
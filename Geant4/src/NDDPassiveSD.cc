@@ -0,0 +1,46 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDPassiveSD.hh"
+
+#include "G4Gamma.hh"
+#include "G4Step.hh"
+#include "G4VProcess.hh"
+#include "G4VTouchable.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPassiveSD::NDDPassiveSD(const G4String& name)
+    : G4VSensitiveDetector(name), eDep(0.), bremsstrahlungLoss(0.) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPassiveSD::~NDDPassiveSD() {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPassiveSD::Initialize(G4HCofThisEvent*) {
+  eDep = 0.;
+  bremsstrahlungLoss = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDPassiveSD::ProcessHits(G4Step* aStep, G4TouchableHistory*) {
+  eDep += aStep->GetTotalEnergyDeposit();
+
+  // a bremsstrahlung photon leaving into the mother volume, the vacuum
+  const G4Track* track = aStep->GetTrack();
+  if (track->GetDefinition() != G4Gamma::Definition()) return true;
+  const G4VProcess* creator = track->GetCreatorProcess();
+  if (!creator || creator->GetProcessName() != "eBrem") return true;
+  G4StepPoint* post = aStep->GetPostStepPoint();
+  if (post->GetPhysicalVolume() &&
+      post->GetPhysicalVolume() ==
+          aStep->GetPreStepPoint()->GetTouchable()->GetVolume(1)) {
+    bremsstrahlungLoss += post->GetKineticEnergy();
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -1,5 +1,7 @@
 #include "NDDPhysicsList.hh"
 #include "NDDPhysicsListMessenger.hh"
+#include "NDDGuidingCentreModel.hh"
+#include "NDDUserLimits.hh"
 
 #include "PhysListEmStandard.hh"
 #include "PhysListEmStandardSS.hh"   //single scattering model
@@ -24,6 +26,12 @@
 #include "G4DecayPhysics.hh"
 #include "G4RadioactiveDecayPhysics.hh"
 
+#include "G4FastSimulationHelper.hh"
+#include "G4ParticleTable.hh"
+#include "G4PhysicsListHelper.hh"
+#include "G4ProcessManager.hh"
+#include "G4UserSpecialCuts.hh"
+
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Geantino.hh"
@@ -96,6 +104,43 @@ void NDDPhysicsList::ConstructParticle() {
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void NDDPhysicsList::ConstructProcess() {
+  G4VModularPhysicsList::ConstructProcess();
+
+  // Guiding-centre transport in the vacuum. Attached here rather than as a
+  // physics constructor, so that it follows /NDD/guidingCentre/enable,
+  // given after the physics list is built; otherwise no fast simulation
+  // process sits in the way of full tracking.
+  if (NDDGuidingCentreModel::IsEnabled()) {
+    const char* particles[] = {"e-", "e+", "proton"};
+    G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
+    for (const char* name : particles) {
+      G4FastSimulationHelper::ActivateFastSimulation(
+          particleTable->FindParticle(name)->GetProcessManager());
+    }
+  }
+
+  // The time and energy kills of /NDD/limits/, neutral particles included,
+  // only when some are set: G4UserSpecialCuts alone, without the
+  // G4StepLimiter of G4StepLimiterPhysics, so that the maximum steps of
+  // the user limits stay unenforced as before.
+  if (NDDUserLimits::IsTimeOrEnergyLimited()) {
+    G4UserSpecialCuts* specialCuts = new G4UserSpecialCuts();
+    G4PhysicsListHelper* helper = G4PhysicsListHelper::GetPhysicsListHelper();
+    G4ParticleTable::G4PTblDicIterator* iterator =
+        G4ParticleTable::GetParticleTable()->GetIterator();
+    iterator->reset();
+    while ((*iterator)()) {
+      G4ParticleDefinition* particle = iterator->value();
+      if (!particle->IsShortLived()) {
+        helper->RegisterProcess(specialCuts, particle);
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void NDDPhysicsList::ReplaceEMPhysicsList(const G4String& name) {
   if (verboseLevel > 1) {
     G4cout << "NDDPhysicsList::AddPhysicsList: <" << name << ">" << G4endl;
@@ -0,0 +1,148 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDPixelMap.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+// axial steps to the six neighbours, counter-clockwise from +y
+const G4int directions[6][2] = {{0, 1}, {-1, 1}, {-1, 0}, {0, -1}, {1, -1}, {1, 0}};
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPixelMap* NDDPixelMap::Instance() {
+  static NDDPixelMap instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPixelMap::NDDPixelMap() : pitch(0.), rings(0), pixelsPerDetector(1) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPixelMap::Build(G4double p, G4int n,
+                        const std::vector<G4String>& names) {
+  pitch = p;
+  rings = n;
+  detectors = names;
+  centres.clear();
+  q.clear();
+  r.clear();
+  G4int width = 2 * rings + 1;
+  lookup.assign(width * width, 0);
+
+  const G4double columnStep = pitch * std::cos(M_PI / 6.);
+  for (G4int qi = -rings; qi <= rings; qi++) {
+    // downwards in y, i.e. decreasing r
+    for (G4int ri = std::min(rings, rings - qi); ri >= std::max(-rings, -rings - qi);
+         ri--) {
+      centres.push_back(G4ThreeVector(qi * columnStep, (ri + qi / 2.) * pitch, 0.));
+      q.push_back(qi);
+      r.push_back(ri);
+      lookup[(qi + rings) * width + ri + rings] = centres.size();
+    }
+  }
+  pixelsPerDetector = centres.size();
+
+  // the other detectors repeat the array of the first
+  for (size_t d = 1; d < detectors.size(); d++) {
+    for (G4int i = 0; i < pixelsPerDetector; i++) {
+      centres.push_back(centres[i]);
+      q.push_back(q[i]);
+      r.push_back(r[i]);
+    }
+  }
+
+  neighbours.assign(centres.size(), std::vector<G4int>());
+  for (size_t i = 0; i < centres.size(); i++) {
+    G4int detector = i / pixelsPerDetector;
+    for (const G4int* d : directions) {
+      G4int neighbour = GetPixel(q[i] + d[0], r[i] + d[1], detector);
+      if (neighbour > 0) neighbours[i].push_back(neighbour);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int NDDPixelMap::GetNeighbour(G4int pixel, G4int k) const {
+  return GetPixel(q[pixel - 1] + directions[k][0], r[pixel - 1] + directions[k][1],
+                  GetDetector(pixel));
+}
+
+G4ThreeVector NDDPixelMap::GetDirection(G4int k) const {
+  G4double phi = M_PI / 2. + k * M_PI / 3.;
+  return G4ThreeVector(std::cos(phi), std::sin(phi), 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int NDDPixelMap::GetPixel(G4int qi, G4int ri, G4int detector) const {
+  if (std::abs(qi) > rings || std::abs(ri) > rings || lookup.empty()) return 0;
+  G4int pixel = lookup[(qi + rings) * (2 * rings + 1) + ri + rings];
+  return pixel > 0 ? GetPixelNumber(detector, pixel) : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int NDDPixelMap::FindPixel(G4double x, G4double y, G4int detector) const {
+  if (!IsBuilt()) return 0;
+  // round the fractional cube coordinates to the nearest hexagon centre
+  G4double fq = x / (pitch * std::cos(M_PI / 6.));
+  G4double fr = y / pitch - fq / 2.;
+  G4double fs = -fq - fr;
+  G4double rq = std::round(fq), rr = std::round(fr), rs = std::round(fs);
+  G4double dq = std::abs(rq - fq), dr = std::abs(rr - fr), ds = std::abs(rs - fs);
+  if (dq > dr && dq > ds) {
+    rq = -rr - rs;
+  } else if (dr > ds) {
+    rr = -rq - rs;
+  }
+  return GetPixel((G4int)rq, (G4int)rr, detector);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int NDDPixelMap::GetDistance(G4int a, G4int b) const {
+  G4int dq = q[a - 1] - q[b - 1], dr = r[a - 1] - r[b - 1];
+  return (std::abs(dq) + std::abs(dr) + std::abs(dq + dr)) / 2;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPixelMap::GetPixelsWithin(G4int pixel, G4int n,
+                                  std::vector<G4int>& pixels) const {
+  pixels.clear();
+  G4int q0 = q[pixel - 1], r0 = r[pixel - 1];
+  G4int detector = GetDetector(pixel);
+  for (G4int dq = -n; dq <= n; dq++) {
+    for (G4int dr = std::min(n, n - dq); dr >= std::max(-n, -n - dq); dr--) {
+      G4int other = GetPixel(q0 + dq, r0 + dr, detector);
+      if (other > 0) pixels.push_back(other);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int NDDPixelMap::GetStepsWithin(G4double distance) const {
+  // a pixel n steps away is at least n pitch cos(30) from the centre
+  return (G4int)std::ceil(distance / (pitch * std::cos(M_PI / 6.)));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String NDDPixelMap::GetName(G4int pixel) const {
+  std::ostringstream name;
+  G4int detector = GetDetector(pixel);
+  name << pixel - GetPixelNumber(detector, 0) << detectors[detector];
+  return name.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
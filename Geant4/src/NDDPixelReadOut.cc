@@ -1,5 +1,7 @@
 #include "NDDPixelReadOut.hh"
+#include "NDDDetectorConstruction.hh"
 #include "NDDSiPixelSD.hh"
+#include "NDDPixelMap.hh"
 
 #include "G4Material.hh"
 #include "G4LogicalVolume.hh"
@@ -8,10 +10,13 @@
 #include "G4SDManager.hh"
 #include "G4Polyhedra.hh"
 #include "G4Tubs.hh"
+#include "G4RotationMatrix.hh"
 #include "G4ThreeVector.hh"
 #include "G4SystemOfUnits.hh"
 
-NDDPixelReadOut::NDDPixelReadOut(G4String& parallelWorldName) : G4VUserParallelWorld(parallelWorldName) {}
+NDDPixelReadOut::NDDPixelReadOut(G4String& parallelWorldName,
+                                 const NDDDetectorConstruction* d)
+    : G4VUserParallelWorld(parallelWorldName), detector(d) {}
 
 NDDPixelReadOut::~NDDPixelReadOut() {}
 
@@ -22,11 +27,6 @@ void NDDPixelReadOut::Construct() {
 
   G4Material* dummyMat = nullptr;
 
-  //TODO not hardcoded
-  G4double xSilicon = 0;
-  G4double ySilicon = 0;
-  G4double zSilicon = 10 * mm + (siThickness + deadLayerThickness) / 2;
-
   G4VPhysicalVolume* physicalROWorld = GetWorld();
   G4LogicalVolume* logicalROWorld = physicalROWorld->GetLogicalVolume();
 
@@ -34,10 +34,23 @@ void NDDPixelReadOut::Construct() {
                                 (siThickness + deadLayerThickness) / 2., 0., 360. * deg);
   G4LogicalVolume* logicalROSilicon = new G4LogicalVolume(solidROSilicon, dummyMat,
                                            "logicalROSilicon");
-  new G4PVPlacement(
-      0,
-      G4ThreeVector(xSilicon, ySilicon, zSilicon),
-      logicalROSilicon, "physicalROSilicon", logicalROWorld, false, 0);
+
+  // one placement per detector of the mass geometry, behind its face
+  const std::vector<NDDDetector>& detectors = detector->GetDetectors();
+  std::vector<G4String> names;
+  for (G4int d = 0; d < (G4int)detectors.size(); d++) {
+    const NDDDetector& det = detectors[d];
+    names.push_back(det.name);
+    G4double zSilicon = (siThickness + deadLayerThickness) / 2;
+    G4RotationMatrix* flip = nullptr;
+    if (det.side < 0) {
+      flip = new G4RotationMatrix();
+      flip->rotateX(180. * deg);
+    }
+    new G4PVPlacement(
+        flip, det.face + G4ThreeVector(0., 0., det.side * zSilicon),
+        logicalROSilicon, "physicalROSilicon", logicalROWorld, false, d);
+  }
 
   G4double pixelSize = 7 * mm;
 
@@ -50,24 +63,15 @@ void NDDPixelReadOut::Construct() {
   G4LogicalVolume* logicalPixel =
       new G4LogicalVolume(solidPixel, dummyMat, "logicalROPixel");
 
-  G4int pixelRings = 6;
-  G4int columns = 2 * pixelRings + 1;
-
-  //copy number
-  G4int cn = 1;
-  for (int column = 1; column <= columns; column++) {
-    for (int row = std::abs((columns + 1) / 2 - column) / 2 - (column) % 2;
-         row < columns - std::abs((columns + 1) / 2 - column) / 2 - 1; row++) {
-      new G4PVPlacement(
-          0, G4ThreeVector(-((columns + 1) / 2 - column) * pixelSize *
-                               std::cos(M_PI / 6.0),
-                           ((columns + 1) / 2 - row +
-                            std::abs((columns + 1) / 2 - column) % 2 / 2. - 2) *
-                               pixelSize,
-                           -siThickness / 2.0),
-          logicalPixel, "SiROPixel", logicalROSilicon, false, cn);
-      cn++;
-    }
+  // the pixel layout and numbering is kept in the shared NDDPixelMap; the
+  // copy number is the pixel number on its detector
+  NDDPixelMap* pixelMap = NDDPixelMap::Instance();
+  pixelMap->Build(pixelSize, 6, names);
+  for (G4int pixel = 1; pixel <= pixelMap->GetPixelsPerDetector(); pixel++) {
+    G4ThreeVector centre =
+        pixelMap->GetCentre(pixel) + G4ThreeVector(0., 0., -siThickness / 2.0);
+    new G4PVPlacement(0, centre, logicalPixel, "SiROPixel", logicalROSilicon,
+                      false, pixel);
   }
 }
 
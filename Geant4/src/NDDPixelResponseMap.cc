@@ -0,0 +1,182 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDPixelResponseMap.hh"
+
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace {
+G4Mutex responseMapMutex = G4MUTEX_INITIALIZER;
+std::map<G4String, NDDPixelResponseMap*> loadedMaps;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const NDDPixelResponseMap* NDDPixelResponseMap::Load(const G4String& filename) {
+  G4AutoLock lock(&responseMapMutex);
+
+  auto it = loadedMaps.find(filename);
+  if (it != loadedMaps.end()) return it->second;
+
+  NDDPixelResponseMap* map = new NDDPixelResponseMap(filename);
+  if (!map->Read()) {
+    delete map;
+    return nullptr;
+  }
+  loadedMaps[filename] = map;
+  return map;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPixelResponseMap::NDDPixelResponseMap(const G4String& fn)
+    : filename(fn), pixelSideLow(true), nx(0), ny(0), nz(0) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDPixelResponseMap::Read() {
+  std::ifstream in(filename);
+  if (!in) {
+    G4cout << "ERROR: cannot open pixel response map " << filename << G4endl;
+    return false;
+  }
+
+  G4double xMax = 0., yMax = 0., zMax = 0.;
+  size_t nPoints = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t comment = line.find('#');
+    if (comment != std::string::npos) line.erase(comment);
+
+    std::istringstream iss(line);
+    std::string key;
+    if (!(iss >> key)) continue;
+
+    if (key == "pixelSide") {
+      std::string side;
+      iss >> side;
+      pixelSideLow = side != "zmax";
+    } else if (key == "grid") {
+      iss >> nx >> ny >> nz;
+      nPoints = (size_t)nx * ny * nz;
+      potential.reserve(nPoints);
+      timeCollected.reserve(nPoints);
+      timeOther.reserve(nPoints);
+    } else if (key == "range") {
+      iss >> xMin >> xMax >> yMin >> yMax >> zMin >> zMax;
+    } else {
+      std::istringstream values(line);
+      G4double w, tc, to;
+      if (values >> w >> tc >> to) {
+        potential.push_back(w);
+        timeCollected.push_back(tc * ns);
+        timeOther.push_back(to * ns);
+      }
+    }
+  }
+
+  if (nx < 2 || ny < 2 || nz < 2 || potential.size() != nPoints) {
+    G4cout << "ERROR: pixel response map " << filename << " has "
+           << potential.size() << " points for a " << nx << "x" << ny << "x"
+           << nz << " grid" << G4endl;
+    return false;
+  }
+
+  xMin *= mm;
+  yMin *= mm;
+  zMin *= mm;
+  dx = (xMax * mm - xMin) / (nx - 1);
+  dy = (yMax * mm - yMin) / (ny - 1);
+  dz = (zMax * mm - zMin) / (nz - 1);
+
+  G4cout << "Loaded pixel response map " << filename << " with " << nx << "x"
+         << ny << "x" << nz << " points" << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDPixelResponseMap::GetColumn(G4double x, G4double y,
+                                      Column& column) const {
+  G4double fx = (x - xMin) / dx;
+  G4double fy = (y - yMin) / dy;
+  if (fx < 0 || fy < 0 || fx > nx - 1 || fy > ny - 1) return false;
+
+  G4int ix = std::min((G4int)fx, nx - 2);
+  G4int iy = std::min((G4int)fy, ny - 2);
+  fx -= ix;
+  fy -= iy;
+
+  column.index[0] = (ix * ny + iy) * nz;
+  column.index[1] = (ix * ny + iy + 1) * nz;
+  column.index[2] = ((ix + 1) * ny + iy) * nz;
+  column.index[3] = ((ix + 1) * ny + iy + 1) * nz;
+  column.weight[0] = (1 - fx) * (1 - fy);
+  column.weight[1] = (1 - fx) * fy;
+  column.weight[2] = fx * (1 - fy);
+  column.weight[3] = fx * fy;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NDDPixelResponseMap::Interpolate(const std::vector<G4float>& v,
+                                          const Column& c, G4double z) const {
+  G4double fz = (z - zMin) / dz;
+  fz = std::max(0., std::min(fz, nz - 1.));
+  G4int iz = std::min((G4int)fz, nz - 2);
+  fz -= iz;
+
+  G4double low = 0., high = 0.;
+  for (G4int i = 0; i < 4; i++) {
+    low += c.weight[i] * v[c.index[i] + iz];
+    high += c.weight[i] * v[c.index[i] + iz + 1];
+  }
+  return (1 - fz) * low + fz * high;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPixelResponseMap::FillColumn(const std::vector<G4float>& v,
+                                     const Column& c, G4double* out) const {
+  // four contiguous z columns, a loop the compiler vectorizes
+  const G4float* c0 = &v[c.index[0]];
+  const G4float* c1 = &v[c.index[1]];
+  const G4float* c2 = &v[c.index[2]];
+  const G4float* c3 = &v[c.index[3]];
+  G4double w0 = c.weight[0], w1 = c.weight[1];
+  G4double w2 = c.weight[2], w3 = c.weight[3];
+  for (G4int iz = 0; iz < nz; iz++) {
+    out[iz] = w0 * c0[iz] + w1 * c1[iz] + w2 * c2[iz] + w3 * c3[iz];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NDDPixelResponseMap::GetW(const Column& c, G4double z) const {
+  return Interpolate(potential, c, z);
+}
+
+G4double NDDPixelResponseMap::GetTime(const Column& c, G4bool collected,
+                                      G4double z) const {
+  return Interpolate(collected ? timeCollected : timeOther, c, z);
+}
+
+void NDDPixelResponseMap::GetWColumn(const Column& c, G4double* out) const {
+  FillColumn(potential, c, out);
+}
+
+void NDDPixelResponseMap::GetTimeColumn(const Column& c, G4bool collected,
+                                        G4double* out) const {
+  FillColumn(collected ? timeCollected : timeOther, c, out);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,79 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDPixelSpectra.hh"
+
+#include "NDDAnalysis.hh"
+#include "NDDPixelMap.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+
+#include <cmath>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPixelSpectra::NDDPixelSpectra(G4int n, G4double min, G4double max,
+                                 const G4String& u)
+    : nBins(n),
+      unitValue(G4UnitDefinition::GetValueOf(u)),
+      xMin(min / unitValue),
+      xMax(max / unitValue) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPixelSpectra::~NDDPixelSpectra() {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPixelSpectra::Fill(G4int pixel, G4double value, G4double weight) {
+  G4double x = value / unitValue;
+  G4int bin;
+  if (x < xMin) {
+    bin = -1;
+  } else if (x >= xMax) {
+    bin = nBins;
+  } else {
+    bin = (G4int)std::floor((x - xMin) / (xMax - xMin) * nBins);
+  }
+  spectra[pixel][bin] += weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPixelSpectra::Reset() { spectra.clear(); }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPixelSpectra::FillNtuple(G4int ntupleID) const {
+  auto analysisManager = G4AnalysisManager::Instance();
+  const NDDPixelMap* pixelMap = NDDPixelMap::Instance();
+
+  G4double width = (xMax - xMin) / nBins;
+  for (auto& pixel : spectra) {
+    G4String name;
+    if (pixelMap->IsBuilt()) {
+      name = pixelMap->GetName(pixel.first);
+    } else {
+      std::ostringstream pixelName;
+      pixelName << pixel.first << "E";
+      name = pixelName.str();
+    }
+
+    for (auto& bin : pixel.second) {
+      // the edge of the range for underflow and overflow
+      G4double x = bin.first < 0 ? xMin
+                   : bin.first >= nBins ? xMax
+                                        : xMin + (bin.first + 0.5) * width;
+      analysisManager->FillNtupleIColumn(ntupleID, 0, pixel.first);
+      analysisManager->FillNtupleSColumn(ntupleID, 1, name);
+      analysisManager->FillNtupleIColumn(ntupleID, 2, bin.first);
+      analysisManager->FillNtupleDColumn(ntupleID, 3, x * unitValue / keV);
+      analysisManager->FillNtupleDColumn(ntupleID, 4, bin.second);
+      analysisManager->AddNtupleRow(ntupleID);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,171 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDPrecisionMonitor.hh"
+#include "NDDPrecisionMonitorMessenger.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <cmath>
+#include <limits>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPrecisionMonitorMessenger* NDDPrecisionMonitor::messenger = nullptr;
+
+NDDPrecisionMonitor* NDDPrecisionMonitor::Instance() {
+  static NDDPrecisionMonitor instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrecisionMonitor::CreateMessenger() {
+  if (!messenger) messenger = new NDDPrecisionMonitorMessenger();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrecisionMonitor::DeleteMessenger() {
+  delete messenger;
+  messenger = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPrecisionMonitor::NDDPrecisionMonitor()
+    : observable(kNone),
+      target(0.01),
+      checkInterval(100),
+      minEvents(100),
+      peakPixel(1),
+      peakLow(0.),
+      peakHigh(0.),
+      nEvents(0),
+      nSelected(0),
+      converged(false) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrecisionMonitor::SetTarget(const G4String& name, G4double relPrecision) {
+  if (name == "siHit") {
+    observable = kSiHitFraction;
+  } else if (name == "backscatter") {
+    // ClassifyEvent does not count backscatters yet, the digit is always 0
+    G4cout << "ERROR: the backscatter observable is not available, the event "
+              "classification does not count backscatters yet"
+           << G4endl;
+    observable = kNone;
+  } else if (name == "pixelPeak") {
+    observable = kPixelPeak;
+  } else {
+    observable = kNone;
+  }
+  target = relPrecision;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrecisionMonitor::SetPeak(G4int pixel, G4double eLow, G4double eHigh) {
+  peakPixel = pixel;
+  peakLow = eLow;
+  peakHigh = eHigh;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrecisionMonitor::Reset() {
+  nEvents = 0;
+  nSelected = 0;
+  converged = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrecisionMonitor::RecordEvent(G4double enDepSi, G4bool backscatter,
+                                      const std::vector<G4double>& pixelEnDep) {
+  if (observable == kNone) return;
+
+  G4bool selected = false;
+  if (observable == kSiHitFraction) {
+    selected = enDepSi > 0;
+  } else if (observable == kBackscatterFraction) {
+    selected = backscatter;
+  } else if (observable == kPixelPeak) {
+    if (peakPixel > 0 && peakPixel <= (G4int)pixelEnDep.size()) {
+      G4double e = pixelEnDep[peakPixel - 1];
+      selected = e >= peakLow && e < peakHigh;
+    }
+  }
+
+  if (selected) nSelected++;
+  G4long n = ++nEvents;
+
+  if (n >= minEvents && n % checkInterval == 0 &&
+      GetRelativePrecision() <= target) {
+    converged = true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NDDPrecisionMonitor::GetRelativePrecision() const {
+  G4double n = nEvents.load();
+  G4double k = nSelected.load();
+  if (k <= 0) return std::numeric_limits<G4double>::infinity();
+
+  if (observable == kPixelPeak) {
+    // Poisson uncertainty on the number of counts in the peak window
+    return 1. / std::sqrt(k);
+  }
+  // Binomial uncertainty on a fraction p = k/n, relative to p
+  G4double p = k / n;
+  return std::sqrt((1. - p) / (n * p));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String NDDPrecisionMonitor::GetObservableName() const {
+  switch (observable) {
+    case kSiHitFraction:
+      return "Si hit fraction";
+    case kBackscatterFraction:
+      return "backscatter fraction";
+    case kPixelPeak:
+      return "pixel peak counts";
+    default:
+      return "none";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrecisionMonitor::Report() const {
+  if (observable == kNone) return;
+
+  G4long n = nEvents.load();
+  G4long k = nSelected.load();
+
+  G4cout << G4endl << "--------------- Precision target ---------------" << G4endl
+         << " Observable         : " << GetObservableName();
+  if (observable == kPixelPeak) {
+    G4cout << " (pixel " << peakPixel << ", " << peakLow / keV << "-"
+           << peakHigh / keV << " keV)";
+  }
+  G4cout << G4endl << " Events             : " << n << G4endl
+         << " Selected           : " << k;
+  if (observable != kPixelPeak && n > 0) {
+    G4cout << " (" << (G4double)k / n << ")";
+  }
+  G4cout << G4endl
+         << " Relative precision : " << GetRelativePrecision()
+         << " (target " << target << ")" << G4endl
+         << " Status             : "
+         << (converged ? "target reached, run stopped early"
+                       : "target NOT reached")
+         << G4endl << "------------------------------------------------"
+         << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
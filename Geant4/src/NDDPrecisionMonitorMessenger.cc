@@ -0,0 +1,121 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDPrecisionMonitorMessenger.hh"
+#include "NDDPrecisionMonitor.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPrecisionMonitorMessenger::NDDPrecisionMonitorMessenger()
+    : G4UImessenger(),
+      runDir(0),
+      untilPrecisionCmd(0),
+      precisionPeakCmd(0),
+      precisionIntervalCmd(0),
+      precisionMinEventsCmd(0) {
+  runDir = new G4UIdirectory("/NDD/run/");
+  runDir->SetGuidance("Run control.");
+
+  // The precision monitor is shared by all threads, so these are applied
+  // once on the master rather than broadcast to every worker.
+  untilPrecisionCmd = new G4UIcommand("/NDD/run/untilPrecision", this);
+  untilPrecisionCmd->SetGuidance(
+      "Stop the run once an observable reaches a relative uncertainty.");
+  untilPrecisionCmd->SetGuidance(
+      "Use /run/beamOn with an upper limit on the number of events.");
+  untilPrecisionCmd->SetGuidance("  siHit       : fraction of events with Si energy");
+  untilPrecisionCmd->SetGuidance(
+      "  backscatter : not available, backscatters are not classified yet");
+  untilPrecisionCmd->SetGuidance("  pixelPeak   : counts in /NDD/run/precisionPeak");
+  untilPrecisionCmd->SetGuidance("  none        : disable");
+  G4UIparameter* observableParam = new G4UIparameter("observable", 's', false);
+  observableParam->SetParameterCandidates("siHit backscatter pixelPeak none");
+  untilPrecisionCmd->SetParameter(observableParam);
+  G4UIparameter* targetParam = new G4UIparameter("relPrecision", 'd', true);
+  targetParam->SetDefaultValue(0.01);
+  targetParam->SetParameterRange("relPrecision>0.");
+  untilPrecisionCmd->SetParameter(targetParam);
+  untilPrecisionCmd->SetToBeBroadcasted(false);
+  untilPrecisionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  precisionPeakCmd = new G4UIcommand("/NDD/run/precisionPeak", this);
+  precisionPeakCmd->SetGuidance(
+      "Pixel and energy window counted by the pixelPeak observable.");
+  G4UIparameter* pixelParam = new G4UIparameter("pixel", 'i', false);
+  pixelParam->SetParameterRange("pixel>0");
+  precisionPeakCmd->SetParameter(pixelParam);
+  precisionPeakCmd->SetParameter(new G4UIparameter("eLow", 'd', false));
+  precisionPeakCmd->SetParameter(new G4UIparameter("eHigh", 'd', false));
+  G4UIparameter* unitParam = new G4UIparameter("unit", 's', true);
+  unitParam->SetDefaultValue("keV");
+  precisionPeakCmd->SetParameter(unitParam);
+  precisionPeakCmd->SetToBeBroadcasted(false);
+  precisionPeakCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  precisionIntervalCmd =
+      new G4UIcmdWithAnInteger("/NDD/run/precisionCheckInterval", this);
+  precisionIntervalCmd->SetGuidance("Number of events between precision checks.");
+  precisionIntervalCmd->SetParameterName("events", false);
+  precisionIntervalCmd->SetRange("events>0");
+  precisionIntervalCmd->SetToBeBroadcasted(false);
+  precisionIntervalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  precisionMinEventsCmd =
+      new G4UIcmdWithAnInteger("/NDD/run/precisionMinEvents", this);
+  precisionMinEventsCmd->SetGuidance(
+      "Minimum number of events before the run may stop.");
+  precisionMinEventsCmd->SetParameterName("events", false);
+  precisionMinEventsCmd->SetRange("events>=0");
+  precisionMinEventsCmd->SetToBeBroadcasted(false);
+  precisionMinEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPrecisionMonitorMessenger::~NDDPrecisionMonitorMessenger() {
+  delete untilPrecisionCmd;
+  delete precisionPeakCmd;
+  delete precisionIntervalCmd;
+  delete precisionMinEventsCmd;
+  delete runDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrecisionMonitorMessenger::SetNewValue(G4UIcommand* command,
+                                               G4String newValues) {
+  if (command == untilPrecisionCmd) {
+    G4String observable;
+    G4double target;
+    std::istringstream is(newValues);
+    is >> observable >> target;
+    NDDPrecisionMonitor::Instance()->SetTarget(observable, target);
+  }
+
+  if (command == precisionPeakCmd) {
+    G4int pixel;
+    G4double eLow, eHigh;
+    G4String unit;
+    std::istringstream is(newValues);
+    is >> pixel >> eLow >> eHigh >> unit;
+    G4double u = G4UIcommand::ValueOf(unit);
+    NDDPrecisionMonitor::Instance()->SetPeak(pixel, eLow * u, eHigh * u);
+  }
+
+  if (command == precisionIntervalCmd)
+    NDDPrecisionMonitor::Instance()->SetCheckInterval(
+        precisionIntervalCmd->GetNewIntValue(newValues));
+
+  if (command == precisionMinEventsCmd)
+    NDDPrecisionMonitor::Instance()->SetMinEvents(
+        precisionMinEventsCmd->GetNewIntValue(newValues));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
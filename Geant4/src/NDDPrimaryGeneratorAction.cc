@@ -1,23 +1,82 @@
 #include "NDDPrimaryGeneratorAction.hh"
+#include "NDDPrimaryGeneratorMessenger.hh"
+#include "NDDResponseMatrix.hh"
+#include "NDDSurrogateEventInformation.hh"
 
 #include "G4Event.hh"
 #include "G4GeneralParticleSource.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 NDDPrimaryGeneratorAction::NDDPrimaryGeneratorAction()
-    : G4VUserPrimaryGeneratorAction(), particleGun(0) {
+    : G4VUserPrimaryGeneratorAction(),
+      particleGun(0),
+      genMessenger(0),
+      responseMatrix(0),
+      surrogateMode(false) {
   particleGun = new G4GeneralParticleSource();
+  genMessenger = new NDDPrimaryGeneratorMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-NDDPrimaryGeneratorAction::~NDDPrimaryGeneratorAction() { delete particleGun; }
+NDDPrimaryGeneratorAction::~NDDPrimaryGeneratorAction() {
+  delete genMessenger;
+  delete particleGun;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrimaryGeneratorAction::SetResponseMatrix(const G4String& filename) {
+  responseMatrix = NDDResponseMatrix::Load(filename);
+  if (!responseMatrix && surrogateMode) {
+    G4cout << "ERROR: no usable response matrix, surrogate mode disabled."
+           << G4endl;
+    surrogateMode = false;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrimaryGeneratorAction::SetSurrogateMode(G4bool val) {
+  if (val && !responseMatrix) {
+    G4cout << "ERROR: set /NDD/surrogate/responseMatrix before enabling "
+              "surrogate mode."
+           << G4endl;
+    return;
+  }
+  surrogateMode = val;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void NDDPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
-  particleGun->GeneratePrimaryVertex(anEvent);
+  if (surrogateMode) {
+    GenerateSurrogate(anEvent);
+  } else {
+    particleGun->GeneratePrimaryVertex(anEvent);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrimaryGeneratorAction::GenerateSurrogate(G4Event* anEvent) {
+  // Let GPS draw the primary as usual so the energy spectrum and source
+  // definitions are honoured, but keep the vertex out of the real event: with
+  // no primaries there is nothing for the kernel to track.
+  G4Event scratch(anEvent->GetEventID());
+  particleGun->GeneratePrimaryVertex(&scratch);
+
+  G4double primaryEnergy = 0.;
+  G4PrimaryVertex* vertex = scratch.GetPrimaryVertex();
+  if (vertex && vertex->GetPrimary()) {
+    primaryEnergy = vertex->GetPrimary()->GetKineticEnergy();
+  }
+
+  anEvent->SetUserInformation(new NDDSurrogateEventInformation(
+      primaryEnergy, responseMatrix->Sample(primaryEnergy)));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
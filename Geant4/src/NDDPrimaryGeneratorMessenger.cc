@@ -0,0 +1,60 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDPrimaryGeneratorMessenger.hh"
+#include "NDDPrimaryGeneratorAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPrimaryGeneratorMessenger::NDDPrimaryGeneratorMessenger(
+    NDDPrimaryGeneratorAction* action)
+    : G4UImessenger(),
+      fPrimaryGenerator(action),
+      surrogateDir(0),
+      responseMatrixCmd(0),
+      surrogateEnableCmd(0) {
+  surrogateDir = new G4UIdirectory("/NDD/surrogate/");
+  surrogateDir->SetGuidance(
+      "Sample Si deposits from a response matrix instead of tracking.");
+
+  responseMatrixCmd =
+      new G4UIcmdWithAString("/NDD/surrogate/responseMatrix", this);
+  responseMatrixCmd->SetGuidance("Response matrix file to sample from.");
+  responseMatrixCmd->SetGuidance(
+      "Columns: eLow eHigh enSiLow enSiHigh pixel backscatter weight (keV)");
+  responseMatrixCmd->SetParameterName("fileName", false);
+  responseMatrixCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  surrogateEnableCmd = new G4UIcmdWithABool("/NDD/surrogate/enable", this);
+  surrogateEnableCmd->SetGuidance(
+      "Skip transport and sample deposits from the response matrix.");
+  surrogateEnableCmd->SetParameterName("enable", true);
+  surrogateEnableCmd->SetDefaultValue(true);
+  surrogateEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPrimaryGeneratorMessenger::~NDDPrimaryGeneratorMessenger() {
+  delete responseMatrixCmd;
+  delete surrogateEnableCmd;
+  delete surrogateDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDPrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command,
+                                               G4String newValue) {
+  if (command == responseMatrixCmd) {
+    fPrimaryGenerator->SetResponseMatrix(newValue);
+  } else if (command == surrogateEnableCmd) {
+    fPrimaryGenerator->SetSurrogateMode(
+        surrogateEnableCmd->GetNewBoolValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,299 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDProfiler.hh"
+#include "NDDProfilerMessenger.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
+#include "G4Threading.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace {
+const size_t nSlowestEvents = 10;
+
+// Thread-merged summary, keyed by name since pointers differ per thread
+struct Summary {
+  G4int threads = 0;
+  G4long totalSteps = 0;
+  G4long nEvents = 0;
+  G4double eventSum = 0., eventSum2 = 0., eventMax = 0.;
+  std::map<std::pair<G4String, G4String>, std::pair<G4long, G4double> >
+      volumeParticle;
+  std::map<G4String, std::pair<G4long, G4double> > processes;
+  std::map<G4String, G4long> tracks;
+  std::vector<std::pair<G4double, G4int> > slowestEvents;
+};
+
+G4Mutex profilerMutex = G4MUTEX_INITIALIZER;
+Summary summary;
+
+G4ThreadLocal NDDProfiler* threadProfiler = nullptr;
+
+template <class T>
+void WriteCounters(std::ofstream& out, const G4String& key,
+                   const std::vector<std::pair<T, std::pair<G4long, G4double> > >& v,
+                   void (*writeKey)(std::ofstream&, const T&)) {
+  out << "  \"" << key << "\": [";
+  for (size_t i = 0; i < v.size(); i++) {
+    out << (i ? ",\n" : "\n") << "    {";
+    writeKey(out, v[i].first);
+    out << ", \"steps\": " << v[i].second.first
+        << ", \"seconds\": " << v[i].second.second << "}";
+  }
+  out << "\n  ]";
+}
+
+void WriteName(std::ofstream& out, const G4String& name) {
+  out << "\"name\": \"" << name << "\"";
+}
+
+void WriteVolumeParticle(std::ofstream& out,
+                         const std::pair<G4String, G4String>& key) {
+  out << "\"volume\": \"" << key.first << "\", \"particle\": \"" << key.second
+      << "\"";
+}
+
+template <class T>
+std::vector<std::pair<T, std::pair<G4long, G4double> > > SortedByCost(
+    const std::map<T, std::pair<G4long, G4double> >& m) {
+  std::vector<std::pair<T, std::pair<G4long, G4double> > > v(m.begin(), m.end());
+  std::sort(v.begin(), v.end(), [](const std::pair<T, std::pair<G4long, G4double> >& a,
+                                   const std::pair<T, std::pair<G4long, G4double> >& b) {
+    if (a.second.second != b.second.second)
+      return a.second.second > b.second.second;
+    return a.second.first > b.second.first;
+  });
+  return v;
+}
+}
+
+G4int NDDProfiler::level = NDDProfiler::kOff;
+G4String NDDProfiler::outputFile = "";
+NDDProfilerMessenger* NDDProfiler::messenger = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDProfiler* NDDProfiler::Instance() {
+  if (!threadProfiler) threadProfiler = new NDDProfiler();
+  return threadProfiler;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDProfiler::CreateMessenger() {
+  if (!messenger) messenger = new NDDProfilerMessenger();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDProfiler::DeleteMessenger() {
+  delete messenger;
+  messenger = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDProfiler::NDDProfiler() : lastKey(nullptr, nullptr), lastCounter(nullptr) {
+  Reset();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDProfiler::Reset() {
+  volumeParticle.clear();
+  processes.clear();
+  tracks.clear();
+  lastKey = StepKey(nullptr, nullptr);
+  lastCounter = nullptr;
+  currentEvent = -1;
+  totalSteps = 0;
+  nEvents = 0;
+  eventSum = eventSum2 = eventMax = 0.;
+  slowestEvents.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDProfiler::BeginEvent(G4int eventID) {
+  currentEvent = eventID;
+  if (level >= kTiming) eventStartTime = Clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDProfiler::EndEvent() {
+  nEvents++;
+  if (level < kTiming) return;
+
+  G4double t = std::chrono::duration<G4double>(Clock::now() - eventStartTime).count();
+  eventSum += t;
+  eventSum2 += t * t;
+  eventMax = std::max(eventMax, t);
+
+  if (slowestEvents.size() < nSlowestEvents || t > slowestEvents.back().first) {
+    slowestEvents.push_back(std::make_pair(t, currentEvent));
+    std::sort(slowestEvents.begin(), slowestEvents.end(),
+              [](const std::pair<G4double, G4int>& a,
+                 const std::pair<G4double, G4int>& b) { return a.first > b.first; });
+    if (slowestEvents.size() > nSlowestEvents) slowestEvents.pop_back();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDProfiler::BeginTrack(const G4Track* track) {
+  tracks[track->GetDefinition()]++;
+  // time spent between tracks (stacking, secondaries bookkeeping) is not
+  // attributed to the first step of the next track
+  if (level >= kTiming) lastStepTime = Clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDProfiler::RecordStep(const G4Step* step) {
+  totalSteps++;
+
+  StepKey key(step->GetPreStepPoint()->GetPhysicalVolume(),
+              step->GetTrack()->GetDefinition());
+  // consecutive steps almost always share volume and particle
+  if (key != lastKey || !lastCounter) {
+    auto it = volumeParticle.find(key);
+    if (it == volumeParticle.end()) {
+      Counter c = {0, 0.};
+      it = volumeParticle.insert(std::make_pair(key, c)).first;
+    }
+    lastKey = key;
+    lastCounter = &(it->second);
+  }
+  lastCounter->steps++;
+
+  const G4VProcess* process = step->GetPostStepPoint()->GetProcessDefinedStep();
+  Counter& processCounter = processes[process];
+  processCounter.steps++;
+
+  if (level >= kTiming) {
+    Clock::time_point now = Clock::now();
+    G4double dt = std::chrono::duration<G4double>(now - lastStepTime).count();
+    lastStepTime = now;
+    lastCounter->seconds += dt;
+    processCounter.seconds += dt;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDProfiler::MergeToMaster() {
+  if (level == kOff) return;
+
+  G4AutoLock lock(&profilerMutex);
+
+  summary.threads++;
+  summary.totalSteps += totalSteps;
+  summary.nEvents += nEvents;
+  summary.eventSum += eventSum;
+  summary.eventSum2 += eventSum2;
+  summary.eventMax = std::max(summary.eventMax, eventMax);
+
+  for (auto& vp : volumeParticle) {
+    G4String volume = vp.first.first ? vp.first.first->GetName() : "OutOfWorld";
+    G4String particle =
+        vp.first.second ? vp.first.second->GetParticleName() : "unknown";
+    auto& entry = summary.volumeParticle[std::make_pair(volume, particle)];
+    entry.first += vp.second.steps;
+    entry.second += vp.second.seconds;
+  }
+  for (auto& p : processes) {
+    G4String name = p.first ? p.first->GetProcessName() : "unknown";
+    auto& entry = summary.processes[name];
+    entry.first += p.second.steps;
+    entry.second += p.second.seconds;
+  }
+  for (auto& t : tracks) {
+    summary.tracks[t.first->GetParticleName()] += t.second;
+  }
+
+  summary.slowestEvents.insert(summary.slowestEvents.end(),
+                               slowestEvents.begin(), slowestEvents.end());
+
+  Reset();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDProfiler::WriteSummary(const G4String& defaultName) {
+  if (level == kOff) return;
+
+  G4AutoLock lock(&profilerMutex);
+
+  G4String filename =
+      outputFile.empty() ? defaultName + "_profile.json" : outputFile;
+  std::ofstream out(filename);
+  if (!out) {
+    G4cout << "ERROR: cannot write profile summary " << filename << G4endl;
+    return;
+  }
+
+  std::map<G4String, std::pair<G4long, G4double> > volumes;
+  for (auto& vp : summary.volumeParticle) {
+    auto& entry = volumes[vp.first.first];
+    entry.first += vp.second.first;
+    entry.second += vp.second.second;
+  }
+
+  std::sort(summary.slowestEvents.begin(), summary.slowestEvents.end(),
+            [](const std::pair<G4double, G4int>& a,
+               const std::pair<G4double, G4int>& b) { return a.first > b.first; });
+  if (summary.slowestEvents.size() > nSlowestEvents) {
+    summary.slowestEvents.resize(nSlowestEvents);
+  }
+
+  G4double mean = summary.nEvents ? summary.eventSum / summary.nEvents : 0.;
+  G4double rms = summary.nEvents
+                     ? std::sqrt(std::max(0., summary.eventSum2 / summary.nEvents -
+                                                  mean * mean))
+                     : 0.;
+
+  out << "{\n"
+      << "  \"level\": " << level << ",\n"
+      << "  \"threads\": " << summary.threads << ",\n"
+      << "  \"totalSteps\": " << summary.totalSteps << ",\n"
+      << "  \"events\": {\"count\": " << summary.nEvents
+      << ", \"meanSeconds\": " << mean << ", \"rmsSeconds\": " << rms
+      << ", \"maxSeconds\": " << summary.eventMax << ", \"slowest\": [";
+  for (size_t i = 0; i < summary.slowestEvents.size(); i++) {
+    out << (i ? ", " : "") << "{\"eventID\": " << summary.slowestEvents[i].second
+        << ", \"seconds\": " << summary.slowestEvents[i].first << "}";
+  }
+  out << "]},\n";
+
+  WriteCounters(out, "volumes", SortedByCost(volumes), &WriteName);
+  out << ",\n";
+  WriteCounters(out, "volumeParticle", SortedByCost(summary.volumeParticle),
+                &WriteVolumeParticle);
+  out << ",\n";
+  WriteCounters(out, "processes", SortedByCost(summary.processes), &WriteName);
+  out << ",\n  \"tracks\": {";
+  G4bool first = true;
+  for (auto& t : summary.tracks) {
+    out << (first ? "" : ", ") << "\"" << t.first << "\": " << t.second;
+    first = false;
+  }
+  out << "}\n}\n";
+
+  G4cout << "Profile summary (" << summary.totalSteps << " steps, "
+         << summary.nEvents << " events) written to " << filename << G4endl;
+
+  summary = Summary();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,56 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDProfilerMessenger.hh"
+#include "NDDProfiler.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDProfilerMessenger::NDDProfilerMessenger()
+    : G4UImessenger(),
+      profileDir(0),
+      profileLevelCmd(0),
+      profileFileCmd(0) {
+  profileDir = new G4UIdirectory("/NDD/profile/");
+  profileDir->SetGuidance("CPU profiling of events, volumes and processes.");
+
+  profileLevelCmd = new G4UIcmdWithAnInteger("/NDD/profile/level", this);
+  profileLevelCmd->SetGuidance("0: off");
+  profileLevelCmd->SetGuidance("1: step counts per volume, particle and process");
+  profileLevelCmd->SetGuidance("2: as 1, plus wall time per event, volume and process");
+  profileLevelCmd->SetParameterName("level", false);
+  profileLevelCmd->SetRange("level>=0 && level<=2");
+  profileLevelCmd->SetToBeBroadcasted(false);
+  profileLevelCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  profileFileCmd = new G4UIcmdWithAString("/NDD/profile/file", this);
+  profileFileCmd->SetGuidance(
+      "JSON summary file, default <output filename>_profile.json");
+  profileFileCmd->SetParameterName("fileName", false);
+  profileFileCmd->SetToBeBroadcasted(false);
+  profileFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDProfilerMessenger::~NDDProfilerMessenger() {
+  delete profileLevelCmd;
+  delete profileFileCmd;
+  delete profileDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDProfilerMessenger::SetNewValue(G4UIcommand* command,
+                                       G4String newValues) {
+  if (command == profileLevelCmd)
+    NDDProfiler::SetLevel(profileLevelCmd->GetNewIntValue(newValues));
+
+  if (command == profileFileCmd) NDDProfiler::SetOutputFile(newValues);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,157 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDPulseTemplates.hh"
+
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace {
+G4Mutex templatesMutex = G4MUTEX_INITIALIZER;
+std::map<G4String, NDDPulseTemplates*> loadedTemplates;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const NDDPulseTemplates* NDDPulseTemplates::Load(const G4String& filename) {
+  G4AutoLock lock(&templatesMutex);
+
+  auto it = loadedTemplates.find(filename);
+  if (it != loadedTemplates.end()) return it->second;
+
+  NDDPulseTemplates* templates = new NDDPulseTemplates(filename);
+  if (!templates->Read()) {
+    delete templates;
+    return nullptr;
+  }
+  loadedTemplates[filename] = templates;
+  return templates;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDPulseTemplates::NDDPulseTemplates(const G4String& fn)
+    : filename(fn),
+      period(0.),
+      nDepth(0),
+      nRadius(0),
+      nAngle(0),
+      nSamples(0),
+      zMin(0.),
+      zMax(0.),
+      rMax(0.) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDPulseTemplates::Read() {
+  std::ifstream in(filename);
+  if (!in) {
+    G4cout << "ERROR: cannot open pulse templates " << filename << G4endl;
+    return false;
+  }
+
+  size_t nTemplates = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t comment = line.find('#');
+    if (comment != std::string::npos) line.erase(comment);
+
+    std::istringstream iss(line);
+    std::string key;
+    if (!(iss >> key)) continue;
+
+    if (key == "period") {
+      iss >> period;
+    } else if (key == "grid") {
+      iss >> nDepth >> nRadius >> nAngle >> nSamples;
+      nTemplates = (size_t)nDepth * nRadius * nAngle;
+      samples.reserve(nTemplates * nSamples);
+    } else if (key == "depth") {
+      iss >> zMin >> zMax;
+    } else if (key == "radius") {
+      iss >> rMax;
+    } else {
+      std::istringstream values(line);
+      size_t before = samples.size();
+      G4double s;
+      while (values >> s) samples.push_back(s);
+      if (samples.size() - before != (size_t)nSamples) {
+        G4cout << "ERROR: pulse template " << before / std::max(nSamples, 1)
+               << " in " << filename << " does not have " << nSamples
+               << " samples" << G4endl;
+        return false;
+      }
+    }
+  }
+
+  if (nDepth < 2 || nRadius < 2 || nAngle < 1 || nSamples < 1 ||
+      period <= 0 || samples.size() != nTemplates * nSamples) {
+    G4cout << "ERROR: pulse templates " << filename << " have "
+           << samples.size() / std::max(nSamples, 1) << " templates for a "
+           << nDepth << "x" << nRadius << "x" << nAngle << " grid" << G4endl;
+    return false;
+  }
+
+  period *= ns;
+  zMin *= mm;
+  zMax *= mm;
+  rMax *= mm;
+
+  G4cout << "Loaded " << nTemplates << " pulse templates of " << nSamples
+         << " samples from " << filename << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDPulseTemplates::GetWeights(G4double depth, G4double x, G4double y,
+                                     Weights& w) const {
+  G4double r = std::sqrt(x * x + y * y);
+  if (r > rMax) return false;
+
+  G4double fz = (depth - zMin) / (zMax - zMin) * (nDepth - 1);
+  fz = std::max(0., std::min(fz, nDepth - 1.));
+  G4int iz = std::min((G4int)fz, nDepth - 2);
+  fz -= iz;
+
+  G4double fr = r / rMax * (nRadius - 1);
+  G4int ir = std::min((G4int)fr, nRadius - 2);
+  fr -= ir;
+
+  // fold into 0-30 deg, the hexagon repeats every 60 deg and is mirror
+  // symmetric about its axes
+  G4int ia = 0;
+  G4double fa = 0.;
+  if (nAngle > 1) {
+    G4double phi = std::fmod(std::atan2(std::abs(y), std::abs(x)), 60. * deg);
+    if (phi > 30. * deg) phi = 60. * deg - phi;
+    fa = phi / (30. * deg) * (nAngle - 1);
+    ia = std::min((G4int)fa, nAngle - 2);
+    fa -= ia;
+  }
+
+  w.n = 0;
+  for (G4int dz = 0; dz < 2; dz++) {
+    for (G4int dr = 0; dr < 2; dr++) {
+      for (G4int da = 0; da < (nAngle > 1 ? 2 : 1); da++) {
+        G4double weight = (dz ? fz : 1 - fz) * (dr ? fr : 1 - fr) *
+                          (nAngle > 1 ? (da ? fa : 1 - fa) : 1.);
+        if (weight == 0.) continue;
+        size_t index = ((size_t)(iz + dz) * nRadius + ir + dr) * nAngle + ia + da;
+        w.templ[w.n] = &samples[index * nSamples];
+        w.weight[w.n] = weight;
+        w.n++;
+      }
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,122 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDResponseMatrix.hh"
+
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace {
+G4Mutex responseMatrixMutex = G4MUTEX_INITIALIZER;
+std::map<G4String, NDDResponseMatrix*> loadedMatrices;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const NDDResponseMatrix* NDDResponseMatrix::Load(const G4String& filename) {
+  G4AutoLock lock(&responseMatrixMutex);
+
+  auto it = loadedMatrices.find(filename);
+  if (it != loadedMatrices.end()) return it->second;
+
+  NDDResponseMatrix* matrix = new NDDResponseMatrix(filename);
+  if (!matrix->Read()) {
+    delete matrix;
+    return nullptr;
+  }
+  loadedMatrices[filename] = matrix;
+  return matrix;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDResponseMatrix::NDDResponseMatrix(const G4String& fn) : filename(fn) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDResponseMatrix::Read() {
+  std::ifstream in(filename);
+  if (!in) {
+    G4cout << "ERROR: cannot open response matrix " << filename << G4endl;
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t comment = line.find('#');
+    if (comment != std::string::npos) line.erase(comment);
+
+    std::istringstream iss(line);
+    G4double eLow, eHigh, enSiLow, enSiHigh, weight;
+    G4int pixel, backscatter;
+    if (!(iss >> eLow >> eHigh >> enSiLow >> enSiHigh >> pixel >> backscatter >>
+          weight)) {
+      continue;
+    }
+    if (weight <= 0) continue;
+
+    eLow *= keV;
+    eHigh *= keV;
+    if (bins.empty() || bins.back().eLow != eLow || bins.back().eHigh != eHigh) {
+      EnergyBin bin;
+      bin.eLow = eLow;
+      bin.eHigh = eHigh;
+      bins.push_back(bin);
+    }
+
+    EnergyBin& bin = bins.back();
+    Outcome outcome = {enSiLow * keV, enSiHigh * keV, pixel, backscatter != 0};
+    bin.outcomes.push_back(outcome);
+    bin.cumulative.push_back(
+        (bin.cumulative.empty() ? 0. : bin.cumulative.back()) + weight);
+  }
+
+  if (bins.empty()) {
+    G4cout << "ERROR: response matrix " << filename << " contains no entries"
+           << G4endl;
+    return false;
+  }
+
+  std::sort(bins.begin(), bins.end(),
+            [](const EnergyBin& a, const EnergyBin& b) { return a.eLow < b.eLow; });
+
+  G4cout << "Loaded response matrix " << filename << " with " << bins.size()
+         << " primary energy bins" << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDResponseSample NDDResponseMatrix::Sample(G4double primaryEnergy) const {
+  NDDResponseSample sample = {0., 0, false};
+
+  auto bin = std::upper_bound(
+      bins.begin(), bins.end(), primaryEnergy,
+      [](G4double e, const EnergyBin& b) { return e < b.eLow; });
+  if (bin == bins.begin()) return sample;
+  --bin;
+  if (primaryEnergy >= bin->eHigh) return sample;
+
+  G4double r = G4UniformRand() * bin->cumulative.back();
+  size_t i = std::upper_bound(bin->cumulative.begin(), bin->cumulative.end(), r) -
+             bin->cumulative.begin();
+  if (i >= bin->outcomes.size()) i = bin->outcomes.size() - 1;
+
+  const Outcome& outcome = bin->outcomes[i];
+  if (outcome.pixelNumber > 0) {
+    sample.enDepSi = outcome.enSiLow +
+                     G4UniformRand() * (outcome.enSiHigh - outcome.enSiLow);
+    sample.pixelNumber = outcome.pixelNumber;
+  }
+  sample.backscatter = outcome.backscatter;
+  return sample;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
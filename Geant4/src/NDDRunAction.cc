@@ -3,8 +3,22 @@
 
 #include "NDDRunAction.hh"
 #include "NDDRunMessenger.hh"
+#include "NDDPrecisionMonitor.hh"
+#include "NDDEventFilter.hh"
+#include "NDDHitStream.hh"
+#include "NDDHitClusterer.hh"
+#include "NDDDigitizer.hh"
+#include "NDDTrigger.hh"
+#include "NDDProfiler.hh"
+#include "NDDChargeSharing.hh"
+#include "NDDPixelSpectra.hh"
+#include "NDDPixelMap.hh"
+#include "NDDUserLimits.hh"
 
 #include "G4Run.hh"
+#include "G4Threading.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4AccumulableManager.hh"
 #include "G4UImanager.hh"
 #include "G4VVisManager.hh"
 
@@ -12,14 +26,53 @@
 
 #include "NDDAnalysis.hh"
 
+#include <sstream>
+
+namespace {
+// indexed by NDDNtupleID
+const char* ntupleNames[kNumberOfNtuples] = {
+    "energy", "spaceTime", "hits", "pixelEnergies", "VisitedVolumes",
+    "clusters", "waveforms", "triggers", "pixelMap", "pixelSpectra"};
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 NDDRunAction::NDDRunAction()
-    : G4UserRunAction(), runMessenger(0), fSaveRndm(0) {
+    : G4UserRunAction(),
+      runMessenger(0),
+      fSaveRndm(0),
+      pixelSpectra(0),
+      nrH1(0),
+      nrH2(0),
+      filterH1(-1),
+      ntuplesBooked(false),
+      generalHistograms(false),
+      pixelHistograms(true),
+      histograms2D(true),
+      hitsColumnSet(kHitsFull),
+      hitsPrecision(kHitsDouble),
+      hitsPerEvent(false),
+      nPixelColumns(0) {
   filename = "test";
+  for (G4int i = 0; i < kNumberOfNtuples; i++) ntupleEnabled[i] = true;
   runMessenger = new NDDRunMessenger(this);
 
+  // The shared components are configured once on the master, their
+  // commands are not broadcast and only exist there.
+  if (G4Threading::IsMasterThread()) {
+    NDDPrecisionMonitor::CreateMessenger();
+    NDDProfiler::CreateMessenger();
+    NDDHitStream::CreateMessenger();
+    NDDHitClusterer::CreateMessenger();
+    NDDDigitizer::CreateMessenger();
+    NDDChargeSharing::CreateMessenger();
+    NDDTrigger::CreateMessenger();
+    NDDEventFilter::CreateMessenger();
+  }
+
+  // registered on every thread, merged in EndOfRunAction
+  NDDUserLimits::CreateAccumulables();
+
   auto analysisManager = G4AnalysisManager::Instance();
   analysisManager->SetVerboseLevel(1);
   analysisManager->SetNtupleMerging(true); // Only relevant when writing to ROOT
@@ -29,7 +82,6 @@ NDDRunAction::NDDRunAction()
   analysisManager->SetActivation(true);
 
   G4int bins = 1500;
-  G4int nrH1 = 8;
 
   // General histograms
   analysisManager->CreateH1("enPrimary", "Primary energy", bins, 0, 1.500,
@@ -50,30 +102,32 @@ NDDRunAction::NDDRunAction()
                             0.250, "keV");
   analysisManager->CreateH1("timeSi", "Time distribution for Si", bins,
                             0, 500, "ns");
+  analysisManager->CreateH1("enBacking", "Energy deposited in detector backing",
+                            bins, 0, 0.500, "keV");
+  nrH1 = 9;
 
-  // Pixel histograms
-  for (G4int i = 0; i < 128; i++) {
-    std::ostringstream name;
-    name << i + 1 << "E";
+  // Event filter counters, for normalizing filtered and prescaled output
+  filterH1 = analysisManager->CreateH1(
+      "eventFilter", "all, accepted, rejected, prescaled, prescale factor",
+      5, 0, 5);
 
-    analysisManager->CreateH1(name.str(),
-                              "Energy distribution for " + name.str(), bins, 0,
-                              1.500, "keV");
-  }
-
-  G4int nrH2 = 2;
+  // Pixel spectra, written as the sparse pixelSpectra ntuple
+  pixelSpectra = new NDDPixelSpectra(bins, 0, 1.500, "keV");
 
   analysisManager->CreateH2("poeSi", "First hit distribution on Si",
                             100, -5, 5, 100, -5, 5, "cm", "cm");
   analysisManager->CreateH2("penetrationSi", "Penetration depth on Si",
                             100, 10., 10.5, 100, -5, 5, "mm", "cm");
+  nrH2 = 2;
 
-  for (G4int i = 0; i < nrH1; i++) {
-    analysisManager->SetH1Activation(i, false);
-  }
-  for (G4int i = 0; i < nrH2; i++) {
-    analysisManager->SetH2Activation(i, true);
-  }
+  // Ntuples are booked at the start of the first run, once the geometry
+  // and the /NDD/output/ column selection are known.
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDRunAction::BookNtuples() {
+  auto analysisManager = G4AnalysisManager::Instance();
 
   analysisManager->CreateNtuple("energy", "Energy variables");
   analysisManager->CreateNtupleIColumn("iD");
@@ -85,6 +139,9 @@ NDDRunAction::NDDRunAction()
   analysisManager->CreateNtupleDColumn("enCarrier");
   analysisManager->CreateNtupleDColumn("enSourceHolder");
   analysisManager->CreateNtupleDColumn("bremsstrahlungLoss");
+  analysisManager->CreateNtupleIColumn("provenance"); // 0 transport, 1 surrogate
+  analysisManager->CreateNtupleDColumn("weight"); // prescale of kept events
+  analysisManager->CreateNtupleDColumn("enBacking");
   analysisManager->FinishNtuple();
 
   analysisManager->CreateNtuple("spaceTime", "Position and timing variables");
@@ -97,34 +154,26 @@ NDDRunAction::NDDRunAction()
   analysisManager->CreateNtupleDColumn("poeYSi");
   analysisManager->FinishNtuple();
 
-  analysisManager->CreateNtuple("hits", "Detector hits");
-  analysisManager->CreateNtupleIColumn("iD");
-  analysisManager->CreateNtupleIColumn("classification");
-  analysisManager->CreateNtupleDColumn("enPrimary");
-  analysisManager->CreateNtupleDColumn("eDep");
-  analysisManager->CreateNtupleDColumn("x");
-  analysisManager->CreateNtupleDColumn("y");
-  analysisManager->CreateNtupleDColumn("z");
-  analysisManager->CreateNtupleDColumn("px");
-  analysisManager->CreateNtupleDColumn("py");
-  analysisManager->CreateNtupleDColumn("pz");
-  analysisManager->CreateNtupleDColumn("time");
-  analysisManager->CreateNtupleIColumn("particle");
-  analysisManager->CreateNtupleIColumn("pixelNumber");
-  analysisManager->FinishNtuple();
+  BookHitsNtuple();
+
+  // one column per readout pixel; fall back to the full 128 pixel detector
+  // when no readout world has been built
+  const NDDPixelMap* pixelMap = NDDPixelMap::Instance();
+  nPixelColumns = pixelMap->GetNumberOfPixels();
+  if (nPixelColumns <= 0) nPixelColumns = 128;
 
   analysisManager->CreateNtuple("pixelEnergies", "Pixel hits");
   analysisManager->CreateNtupleIColumn("iD");
   analysisManager->CreateNtupleIColumn("classification");
   analysisManager->CreateNtupleDColumn("enPrimary");
-  for (G4int i = 1; i <= 128; i++) {
-    std::ostringstream pixelName;
-    if (i < 128) {
-      pixelName << i << "E";
+  for (G4int i = 1; i <= nPixelColumns; i++) {
+    if (pixelMap->IsBuilt()) {
+      analysisManager->CreateNtupleDColumn(pixelMap->GetName(i));
     } else {
-      pixelName << i % 128 + 1 << "W";
+      std::ostringstream pixelName;
+      pixelName << i << "E";
+      analysisManager->CreateNtupleDColumn(pixelName.str());
     }
-    analysisManager->CreateNtupleDColumn(pixelName.str());
   }
   analysisManager->FinishNtuple();
 
@@ -138,8 +187,230 @@ NDDRunAction::NDDRunAction()
   analysisManager->CreateNtupleSColumn("volume");
   analysisManager->FinishNtuple();
 
-  for (G4int i = 0; i < 5; i++) {
-    analysisManager->SetNtupleActivation(i, true);
+  analysisManager->CreateNtuple("clusters", "Charge clouds from merged hits");
+  analysisManager->CreateNtupleIColumn("iD");
+  analysisManager->CreateNtupleIColumn("classification");
+  analysisManager->CreateNtupleIColumn("nHits");
+  analysisManager->CreateNtupleDColumn("eDep");
+  analysisManager->CreateNtupleDColumn("x");
+  analysisManager->CreateNtupleDColumn("y");
+  analysisManager->CreateNtupleDColumn("z");
+  analysisManager->CreateNtupleDColumn("time");
+  analysisManager->CreateNtupleIColumn("pixelNumber");
+  analysisManager->FinishNtuple();
+
+  analysisManager->CreateNtuple("waveforms", "Digitized pixel waveforms");
+  analysisManager->CreateNtupleIColumn("iD");
+  analysisManager->CreateNtupleIColumn("pixelNumber");
+  analysisManager->CreateNtupleDColumn("startTime");
+  analysisManager->CreateNtupleDColumn("samplePeriod");
+  analysisManager->CreateNtupleDColumn("amplitude");
+  analysisManager->CreateNtupleDColumn("time");
+  analysisManager->CreateNtupleDColumn("peakTime");
+  analysisManager->CreateNtupleDColumn("riseTime");
+  analysisManager->CreateNtupleDColumn("samples", waveformSamples);
+  analysisManager->FinishNtuple();
+
+  analysisManager->CreateNtuple("triggers", "Pixels recorded by the trigger");
+  analysisManager->CreateNtupleIColumn("iD");
+  analysisManager->CreateNtupleIColumn("pixelNumber");
+  analysisManager->CreateNtupleDColumn("energy");
+  analysisManager->CreateNtupleDColumn("time");
+  analysisManager->CreateNtupleIColumn("selfTriggered");
+  analysisManager->FinishNtuple();
+
+  analysisManager->CreateNtuple("pixelMap", "Pixel centres and neighbours");
+  analysisManager->CreateNtupleIColumn("pixelNumber");
+  analysisManager->CreateNtupleSColumn("name");
+  analysisManager->CreateNtupleDColumn("x");
+  analysisManager->CreateNtupleDColumn("y");
+  analysisManager->CreateNtupleIColumn("q");
+  analysisManager->CreateNtupleIColumn("r");
+  analysisManager->CreateNtupleIColumn("neighbours", pixelMapNeighbours);
+  analysisManager->CreateNtupleIColumn("detector");
+  analysisManager->FinishNtuple();
+
+  analysisManager->CreateNtuple("pixelSpectra",
+                                "Non-empty bins of the pixel energy spectra");
+  analysisManager->CreateNtupleIColumn("pixelNumber");
+  analysisManager->CreateNtupleSColumn("name");
+  analysisManager->CreateNtupleIColumn("bin");
+  analysisManager->CreateNtupleDColumn("energy");
+  analysisManager->CreateNtupleDColumn("counts");
+  analysisManager->FinishNtuple();
+
+  ntuplesBooked = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDRunAction::BookHitsNtuple() {
+  auto analysisManager = G4AnalysisManager::Instance();
+
+  G4bool momentum = hitsColumnSet == kHitsFull;
+  G4bool details = hitsColumnSet != kHitsMinimal;
+  hitsColumns.precision = hitsPrecision;
+  hitsColumns.perEvent = hitsPerEvent;
+  hitsColumns.iD = hitsColumns.classification = hitsColumns.enPrimary = -1;
+  hitsColumns.nHits = hitsColumns.eDep = -1;
+  hitsColumns.x = hitsColumns.y = hitsColumns.z = -1;
+  hitsColumns.px = hitsColumns.py = hitsColumns.pz = -1;
+  hitsColumns.time = hitsColumns.particle = hitsColumns.pixelNumber = -1;
+  hitsColumns.detector = -1;
+
+  // real-valued columns follow /NDD/output/hitsPrecision; quantizable ones
+  // become integer "_q" columns in quantized mode
+  auto realColumn = [&](const G4String& name, G4bool quantizable) {
+    if (hitsPrecision == kHitsDouble) {
+      return analysisManager->CreateNtupleDColumn(name);
+    } else if (hitsPrecision == kHitsQuantized && quantizable) {
+      return analysisManager->CreateNtupleIColumn(name + "_q");
+    }
+    return analysisManager->CreateNtupleFColumn(name);
+  };
+  auto vectorColumn = [&](const G4String& name, NDDHitsVector& v,
+                          G4bool quantizable) {
+    if (hitsPrecision == kHitsDouble) {
+      return analysisManager->CreateNtupleDColumn(name, v.d);
+    } else if (hitsPrecision == kHitsQuantized && quantizable) {
+      return analysisManager->CreateNtupleIColumn(name + "_q", v.q);
+    }
+    return analysisManager->CreateNtupleFColumn(name, v.f);
+  };
+
+  if (hitsPerEvent) {
+    // one row per event, so the hits of an event stay contiguous however
+    // the worker ntuples are merged
+    analysisManager->CreateNtuple("eventHits", "Detector hits per event");
+    hitsColumns.iD = analysisManager->CreateNtupleIColumn("iD");
+    if (details) {
+      hitsColumns.classification =
+          analysisManager->CreateNtupleIColumn("classification");
+      hitsColumns.enPrimary = realColumn("enPrimary", true);
+    }
+    hitsColumns.nHits = analysisManager->CreateNtupleIColumn("nHits");
+    hitsColumns.eDep = vectorColumn("eDep", eventHits.eDep, true);
+    hitsColumns.x = vectorColumn("x", eventHits.x, true);
+    hitsColumns.y = vectorColumn("y", eventHits.y, true);
+    hitsColumns.z = vectorColumn("z", eventHits.z, true);
+    if (momentum) {
+      hitsColumns.px = vectorColumn("px", eventHits.px, false);
+      hitsColumns.py = vectorColumn("py", eventHits.py, false);
+      hitsColumns.pz = vectorColumn("pz", eventHits.pz, false);
+    }
+    if (details) {
+      hitsColumns.time = vectorColumn("time", eventHits.time, false);
+      hitsColumns.particle =
+          analysisManager->CreateNtupleIColumn("particle", eventHits.particle);
+    }
+    hitsColumns.pixelNumber =
+        analysisManager->CreateNtupleIColumn("pixelNumber", eventHits.pixelNumber);
+    hitsColumns.detector =
+        analysisManager->CreateNtupleIColumn("detector", eventHits.detector);
+    analysisManager->FinishNtuple();
+    return;
+  }
+
+  analysisManager->CreateNtuple("hits", "Detector hits");
+  hitsColumns.iD = analysisManager->CreateNtupleIColumn("iD");
+  if (details) {
+    hitsColumns.classification =
+        analysisManager->CreateNtupleIColumn("classification");
+    hitsColumns.enPrimary = realColumn("enPrimary", true);
+  }
+  hitsColumns.eDep = realColumn("eDep", true);
+  hitsColumns.x = realColumn("x", true);
+  hitsColumns.y = realColumn("y", true);
+  hitsColumns.z = realColumn("z", true);
+  if (momentum) {
+    hitsColumns.px = realColumn("px", false);
+    hitsColumns.py = realColumn("py", false);
+    hitsColumns.pz = realColumn("pz", false);
+  }
+  if (details) {
+    hitsColumns.time = realColumn("time", false);
+    hitsColumns.particle = analysisManager->CreateNtupleIColumn("particle");
+  }
+  hitsColumns.pixelNumber = analysisManager->CreateNtupleIColumn("pixelNumber");
+  hitsColumns.detector = analysisManager->CreateNtupleIColumn("detector");
+  analysisManager->FinishNtuple();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDRunAction::ApplyActivation() {
+  auto analysisManager = G4AnalysisManager::Instance();
+  for (G4int i = 0; i < nrH1; i++) {
+    analysisManager->SetH1Activation(i, generalHistograms);
+  }
+  analysisManager->SetH1Activation(filterH1,
+                                   NDDEventFilter::Instance()->IsActive());
+  for (G4int i = 0; i < nrH2; i++) {
+    analysisManager->SetH2Activation(i, histograms2D);
+  }
+  for (G4int i = 0; i < kNumberOfNtuples; i++) {
+    analysisManager->SetNtupleActivation(i, IsNtupleEnabled(i));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDRunAction::SetNtupleEnabled(const G4String& name, G4bool enable) {
+  for (G4int i = 0; i < kNumberOfNtuples; i++) {
+    if (name == ntupleNames[i]) {
+      ntupleEnabled[i] = enable;
+      return;
+    }
+  }
+  G4cout << "ERROR: unknown ntuple " << name << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDRunAction::IsNtupleEnabled(G4int id) const {
+  // the clusters ntuple needs /NDD/cluster/radius as well
+  if (id == kClustersNtuple && !NDDHitClusterer::IsEnabled()) return false;
+  // and the waveforms one a digitizer map or template library
+  if (id == kWaveformsNtuple && !NDDDigitizer::IsEnabled()) return false;
+  // and the triggers one a threshold
+  if (id == kTriggerNtuple && !NDDTrigger::IsEnabled()) return false;
+  // the pixel map needs the readout world
+  if (id == kPixelMapNtuple && !NDDPixelMap::Instance()->IsBuilt()) return false;
+  // the pixel spectra follow /NDD/output/histograms pixel
+  if (id == kPixelSpectraNtuple && !pixelHistograms) return false;
+  return ntupleEnabled[id];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDRunAction::SetHistogramsEnabled(const G4String& group, G4bool enable) {
+  if (group == "general") {
+    generalHistograms = enable;
+  } else if (group == "pixel") {
+    pixelHistograms = enable;
+  } else if (group == "2D") {
+    histograms2D = enable;
+  } else {
+    G4cout << "ERROR: unknown histogram group " << group << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDRunAction::SetHitsColumnSet(const G4String& set) {
+  if (ntuplesBooked) {
+    G4cout << "ERROR: the hits columns are fixed once the first run has "
+              "started" << G4endl;
+    return;
+  }
+  if (set == "full") {
+    hitsColumnSet = kHitsFull;
+  } else if (set == "noMomentum") {
+    hitsColumnSet = kHitsNoMomentum;
+  } else if (set == "minimal") {
+    hitsColumnSet = kHitsMinimal;
+  } else {
+    G4cout << "ERROR: unknown hits column set " << set << G4endl;
   }
 }
 
@@ -147,15 +418,74 @@ NDDRunAction::NDDRunAction()
 
 NDDRunAction::~NDDRunAction() {
   delete runMessenger;
+  if (G4Threading::IsMasterThread()) {
+    NDDPrecisionMonitor::DeleteMessenger();
+    NDDProfiler::DeleteMessenger();
+    NDDHitStream::DeleteMessenger();
+    NDDHitClusterer::DeleteMessenger();
+    NDDDigitizer::DeleteMessenger();
+    NDDChargeSharing::DeleteMessenger();
+    NDDTrigger::DeleteMessenger();
+    NDDEventFilter::DeleteMessenger();
+  }
+  delete pixelSpectra;
   delete G4AnalysisManager::Instance();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void NDDRunAction::SetHitsPrecision(const G4String& precision) {
+  if (ntuplesBooked) {
+    G4cout << "ERROR: the hits columns are fixed once the first run has "
+              "started" << G4endl;
+    return;
+  }
+  if (precision == "double") {
+    hitsPrecision = kHitsDouble;
+  } else if (precision == "float") {
+    hitsPrecision = kHitsFloat;
+  } else if (precision == "quantized") {
+    hitsPrecision = kHitsQuantized;
+  } else {
+    G4cout << "ERROR: unknown hits precision " << precision << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDRunAction::SetHitsLayout(const G4String& layout) {
+  if (ntuplesBooked) {
+    G4cout << "ERROR: the hits columns are fixed once the first run has "
+              "started" << G4endl;
+    return;
+  }
+  if (layout == "rows") {
+    hitsPerEvent = false;
+  } else if (layout == "events") {
+    hitsPerEvent = true;
+  } else {
+    G4cout << "ERROR: unknown hits layout " << layout << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void NDDRunAction::BeginOfRunAction(const G4Run*) {
+  if (IsMaster()) {
+    NDDPrecisionMonitor::Instance()->Reset();
+    NDDEventFilter::Instance()->Reset();
+  }
+  NDDProfiler::Instance()->Reset();
+  G4AccumulableManager::Instance()->Reset();
+  pixelSpectra->Reset();
+
+  if (!ntuplesBooked) BookNtuples();
+  ApplyActivation();
+
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
   if (analysisManager->IsActive()) {
     analysisManager->OpenFile(filename);
+    FillPixelMapNtuple();
   }
 
   // save Rndm status
@@ -167,8 +497,59 @@ void NDDRunAction::BeginOfRunAction(const G4Run*) {
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void NDDRunAction::FillPixelMapNtuple() {
+  // once per output file: by the only thread, or the first worker, whose
+  // rows are merged into the master's ntuple
+  G4bool writer = G4Threading::IsMultithreadedApplication()
+                      ? G4Threading::G4GetThreadId() == 0
+                      : true;
+  if (!writer || !IsNtupleEnabled(kPixelMapNtuple)) return;
+
+  auto analysisManager = G4AnalysisManager::Instance();
+  const NDDPixelMap* pixelMap = NDDPixelMap::Instance();
+  for (G4int pixel = 1; pixel <= pixelMap->GetNumberOfPixels(); pixel++) {
+    pixelMapNeighbours = pixelMap->GetNeighbours(pixel);
+    const G4ThreeVector& centre = pixelMap->GetCentre(pixel);
+    analysisManager->FillNtupleIColumn(kPixelMapNtuple, 0, pixel);
+    analysisManager->FillNtupleSColumn(kPixelMapNtuple, 1,
+                                       pixelMap->GetName(pixel));
+    analysisManager->FillNtupleDColumn(kPixelMapNtuple, 2, centre.x() / mm);
+    analysisManager->FillNtupleDColumn(kPixelMapNtuple, 3, centre.y() / mm);
+    analysisManager->FillNtupleIColumn(kPixelMapNtuple, 4, pixelMap->GetQ(pixel));
+    analysisManager->FillNtupleIColumn(kPixelMapNtuple, 5, pixelMap->GetR(pixel));
+    analysisManager->FillNtupleIColumn(kPixelMapNtuple, 7,
+                                       pixelMap->GetDetector(pixel));
+    analysisManager->AddNtupleRow(kPixelMapNtuple);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void NDDRunAction::EndOfRunAction(const G4Run*) {
+  if (IsMaster()) {
+    NDDPrecisionMonitor::Instance()->Report();
+    NDDEventFilter::Instance()->Report();
+    NDDEventFilter::Instance()->FillHistogram(filterH1);
+    NDDHitStream::Instance()->EndOfRun();
+  }
+
+  // the MT master tracks nothing itself, it only collects the workers
+  if (!IsMaster() || !G4Threading::IsMultithreadedApplication()) {
+    NDDProfiler::Instance()->MergeToMaster();
+  }
+  if (IsMaster()) NDDProfiler::WriteSummary(filename);
+
+  // workers add their accumulables into the master's copies
+  G4AccumulableManager::Instance()->Merge();
+  if (IsMaster()) NDDUserLimits::Report();
+
+  // every thread writes its own bins, the workers' rows are merged
   auto analysisManager = G4AnalysisManager::Instance();
+  if (!IsMaster() || !G4Threading::IsMultithreadedApplication()) {
+    if (IsNtupleEnabled(kPixelSpectraNtuple)) {
+      pixelSpectra->FillNtuple(kPixelSpectraNtuple);
+    }
+  }
   analysisManager->Write();
   analysisManager->CloseFile();
 
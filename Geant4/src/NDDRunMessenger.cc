@@ -4,10 +4,14 @@
 #include "NDDRunMessenger.hh"
 #include "NDDRunAction.hh"
 
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
 #include "G4UIcmdWithAnInteger.hh"
 #include "G4UIcmdWithAString.hh"
 #include "Randomize.hh"
 
+#include <sstream>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 NDDRunMessenger::NDDRunMessenger(NDDRunAction* action)
@@ -15,7 +19,14 @@ NDDRunMessenger::NDDRunMessenger(NDDRunAction* action)
       fRunAction(action),
       randomDir(0),
       randomSaveCmd(0),
-      randomReadCmd(0) {
+      randomReadCmd(0),
+      outputDir(0),
+      filenameCmd(0),
+      ntupleCmd(0),
+      histogramsCmd(0),
+      hitsColumnsCmd(0),
+      hitsPrecisionCmd(0),
+      hitsLayoutCmd(0) {
   randomDir = new G4UIdirectory("/rndm/");
   randomDir->SetGuidance("Rndm status control.");
 
@@ -35,6 +46,77 @@ NDDRunMessenger::NDDRunMessenger(NDDRunAction* action)
   randomReadCmd->SetParameterName("fileName", true);
   randomReadCmd->SetDefaultValue("beginOfRun.rndm");
   randomReadCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // Every thread owns a run action with its own output settings, so the
+  // output commands are broadcast to the workers.
+  outputDir = new G4UIdirectory("/NDD/output/");
+  outputDir->SetGuidance("Output file, ntuple and histogram selection.");
+
+  filenameCmd = new G4UIcmdWithAString("/NDD/output/filename", this);
+  filenameCmd->SetGuidance("Output file name, without extension.");
+  filenameCmd->SetParameterName("fileName", false);
+  filenameCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  ntupleCmd = new G4UIcommand("/NDD/output/ntuple", this);
+  ntupleCmd->SetGuidance("Enable or disable writing of one ntuple.");
+  ntupleCmd->SetGuidance("Disabled ntuples are not filled at all.");
+  G4UIparameter* ntupleParam = new G4UIparameter("ntuple", 's', false);
+  ntupleParam->SetParameterCandidates(
+      "energy spaceTime hits pixelEnergies VisitedVolumes clusters waveforms "
+      "triggers pixelMap pixelSpectra");
+  ntupleCmd->SetParameter(ntupleParam);
+  G4UIparameter* ntupleFlagParam = new G4UIparameter("enable", 'b', true);
+  ntupleFlagParam->SetDefaultValue(true);
+  ntupleCmd->SetParameter(ntupleFlagParam);
+  ntupleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  histogramsCmd = new G4UIcommand("/NDD/output/histograms", this);
+  histogramsCmd->SetGuidance("Enable or disable a group of histograms.");
+  histogramsCmd->SetGuidance("  general : energy and timing H1s (default off)");
+  histogramsCmd->SetGuidance("  pixel   : per-pixel energy spectra, written as the");
+  histogramsCmd->SetGuidance("            pixelSpectra ntuple (default on)");
+  histogramsCmd->SetGuidance("  2D      : point of entry and penetration (default on)");
+  G4UIparameter* groupParam = new G4UIparameter("group", 's', false);
+  groupParam->SetParameterCandidates("general pixel 2D");
+  histogramsCmd->SetParameter(groupParam);
+  G4UIparameter* histFlagParam = new G4UIparameter("enable", 'b', true);
+  histFlagParam->SetDefaultValue(true);
+  histogramsCmd->SetParameter(histFlagParam);
+  histogramsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  hitsColumnsCmd = new G4UIcmdWithAString("/NDD/output/hitsColumns", this);
+  hitsColumnsCmd->SetGuidance("Column set of the hits ntuple.");
+  hitsColumnsCmd->SetGuidance("  full       : all columns");
+  hitsColumnsCmd->SetGuidance("  noMomentum : without px, py, pz");
+  hitsColumnsCmd->SetGuidance("  minimal    : iD, eDep, x, y, z, pixelNumber");
+  hitsColumnsCmd->SetGuidance("Only effective before the first run.");
+  hitsColumnsCmd->SetParameterName("set", false);
+  hitsColumnsCmd->SetCandidates("full noMomentum minimal");
+  hitsColumnsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  hitsPrecisionCmd = new G4UIcmdWithAString("/NDD/output/hitsPrecision", this);
+  hitsPrecisionCmd->SetGuidance("Storage of the real-valued hits columns.");
+  hitsPrecisionCmd->SetGuidance("  double    : 64 bit floating point");
+  hitsPrecisionCmd->SetGuidance("  float     : 32 bit floating point");
+  hitsPrecisionCmd->SetGuidance(
+      "  quantized : x, y, z in 0.1 um and energies in eV as integer");
+  hitsPrecisionCmd->SetGuidance(
+      "              columns named x_q, eDep_q, ...; others as float");
+  hitsPrecisionCmd->SetGuidance("Only effective before the first run.");
+  hitsPrecisionCmd->SetGuidance("File compression is set with /analysis/compression.");
+  hitsPrecisionCmd->SetParameterName("precision", false);
+  hitsPrecisionCmd->SetCandidates("double float quantized");
+  hitsPrecisionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  hitsLayoutCmd = new G4UIcmdWithAString("/NDD/output/hitsLayout", this);
+  hitsLayoutCmd->SetGuidance("Layout of the hits output.");
+  hitsLayoutCmd->SetGuidance("  rows   : hits ntuple, one row per hit");
+  hitsLayoutCmd->SetGuidance(
+      "  events : eventHits ntuple, one row per event with vector columns");
+  hitsLayoutCmd->SetGuidance("Only effective before the first run.");
+  hitsLayoutCmd->SetParameterName("layout", false);
+  hitsLayoutCmd->SetCandidates("rows events");
+  hitsLayoutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -43,6 +125,13 @@ NDDRunMessenger::~NDDRunMessenger() {
   delete randomSaveCmd;
   delete randomReadCmd;
   delete randomDir;
+  delete filenameCmd;
+  delete ntupleCmd;
+  delete histogramsCmd;
+  delete hitsColumnsCmd;
+  delete hitsPrecisionCmd;
+  delete hitsLayoutCmd;
+  delete outputDir;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -56,6 +145,28 @@ void NDDRunMessenger::SetNewValue(G4UIcommand* command, G4String newValues) {
     G4Random::restoreEngineStatus(newValues);
     G4Random::showEngineStatus();
   }
+
+  if (command == filenameCmd) fRunAction->SetFilename(newValues);
+
+  if (command == ntupleCmd) {
+    G4String name, flag;
+    std::istringstream is(newValues);
+    is >> name >> flag;
+    fRunAction->SetNtupleEnabled(name, G4UIcommand::ConvertToBool(flag));
+  }
+
+  if (command == histogramsCmd) {
+    G4String group, flag;
+    std::istringstream is(newValues);
+    is >> group >> flag;
+    fRunAction->SetHistogramsEnabled(group, G4UIcommand::ConvertToBool(flag));
+  }
+
+  if (command == hitsColumnsCmd) fRunAction->SetHitsColumnSet(newValues);
+
+  if (command == hitsPrecisionCmd) fRunAction->SetHitsPrecision(newValues);
+
+  if (command == hitsLayoutCmd) fRunAction->SetHitsLayout(newValues);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
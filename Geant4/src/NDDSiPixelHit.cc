@@ -20,11 +20,13 @@ NDDSiPixelHit::NDDSiPixelHit()
       trackID(-1),
       enDep(0.),
       pos(G4ThreeVector()),
+      localPos(G4ThreeVector()),
       momentum(G4ThreeVector()),
       field(G4ThreeVector()),
       particleCode(1),
       time(-1),
       pixelNumber(-1),
+      detector(0),
       pixelName("") {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -37,10 +39,12 @@ NDDSiPixelHit::NDDSiPixelHit(const NDDSiPixelHit& right) : G4VHit() {
   trackID = right.trackID;
   enDep = right.enDep;
   pos = right.pos;
+  localPos = right.localPos;
   momentum = right.momentum;
   field = right.field;
   particleCode = right.particleCode;
   pixelNumber = right.pixelNumber;
+  detector = right.detector;
   pixelName = right.pixelName;
   time = right.time;
 }
@@ -51,10 +55,12 @@ const NDDSiPixelHit& NDDSiPixelHit::operator=(const NDDSiPixelHit& right) {
   trackID = right.trackID;
   enDep = right.enDep;
   pos = right.pos;
+  localPos = right.localPos;
   momentum = right.momentum;
   field = right.field;
   particleCode = right.particleCode;
   pixelNumber = right.pixelNumber;
+  detector = right.detector;
   pixelName = right.pixelName;
   time = right.time;
   return *this;
@@ -63,7 +69,7 @@ const NDDSiPixelHit& NDDSiPixelHit::operator=(const NDDSiPixelHit& right) {
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G4int NDDSiPixelHit::operator==(const NDDSiPixelHit& right) const {
-  return ((trackID == right.trackID) && (enDep == right.enDep) && (pos == right.pos) && (momentum == right.momentum) && (field == right.field) && (particleCode == right.particleCode) && (pixelNumber == right.pixelNumber) && (pixelName == right.pixelName) && (time == right.time));
+  return ((trackID == right.trackID) && (enDep == right.enDep) && (pos == right.pos) && (momentum == right.momentum) && (field == right.field) && (particleCode == right.particleCode) && (pixelNumber == right.pixelNumber) && (detector == right.detector) && (pixelName == right.pixelName) && (time == right.time));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
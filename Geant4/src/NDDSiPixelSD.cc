@@ -1,4 +1,5 @@
 #include "NDDSiPixelSD.hh"
+#include "NDDPixelMap.hh"
 
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
@@ -7,6 +8,7 @@
 #include "G4SDManager.hh"
 #include "G4ios.hh"
 #include "G4FieldManager.hh"
+#include "G4TransportationManager.hh"
 #include "G4Field.hh"
 #include "G4TouchableHistory.hh"
 
@@ -62,22 +64,29 @@ G4bool NDDSiPixelSD::ProcessHits(G4Step* aStep, G4TouchableHistory*) {
 
   G4TouchableHistory* theTouchable =
       (G4TouchableHistory*)(aStep->GetPreStepPoint()->GetTouchable());
-  newHit->SetPixelNumber(theTouchable->GetVolume()->GetCopyNo());
+  newHit->SetLocalPos(
+      theTouchable->GetHistory()->GetTopTransform().TransformPoint(pos));
+  // the pixel array of the detector is the mother of the pixel
+  G4int detector = theTouchable->GetCopyNumber(1);
+  newHit->SetDetector(detector);
+  newHit->SetPixelNumber(NDDPixelMap::Instance()->GetPixelNumber(
+      detector, theTouchable->GetVolume()->GetCopyNo()));
   newHit->SetPixelName(theTouchable->GetVolume()->GetName());
 
-  // G4double* field = new G4double[4];
-  // const G4double point[4] = {pos.x() / mm, pos.y() / mm, pos.z() / mm, 0.};
-  // const G4FieldManager* fman = pVol->GetLogicalVolume()->GetFieldManager();
-
-  // if (fman) {
-  //   fman->GetDetectorField()->GetFieldValue(point, field);
-  // }
-  // newHit->SetField(G4ThreeVector(field[0], field[1], field[2]));
+  // the global field, as the detector has no field of its own
+  const G4Field* field = G4TransportationManager::GetTransportationManager()
+                             ->GetFieldManager()
+                             ->GetDetectorField();
+  if (field) {
+    const G4double point[4] = {pos.x(), pos.y(), pos.z(),
+                               aStep->GetPreStepPoint()->GetGlobalTime()};
+    G4double value[6] = {0., 0., 0., 0., 0., 0.};
+    field->GetFieldValue(point, value);
+    newHit->SetField(G4ThreeVector(value[0], value[1], value[2]));
+  }
 
   fHitsCollection->insert(newHit);
 
-  //delete[] field;
-
   return true;
 }
 
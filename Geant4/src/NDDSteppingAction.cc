@@ -2,6 +2,8 @@
 
 #include "NDDDetectorConstruction.hh"
 #include "NDDEventAction.hh"
+#include "NDDProfiler.hh"
+#include "NDDUserLimits.hh"
 
 #include "G4Step.hh"
 #include "G4StepPoint.hh"
@@ -11,11 +13,15 @@
 
 #include <iostream>
 
-NDDSteppingAction::NDDSteppingAction(NDDEventAction *ea) : eventAction(ea) {}
+NDDSteppingAction::NDDSteppingAction(NDDEventAction *ea)
+    : eventAction(ea), profiler(NDDProfiler::Instance()) {}
 
 NDDSteppingAction::~NDDSteppingAction() {}
 
 void NDDSteppingAction::UserSteppingAction(const G4Step *aStep) {
+  if (NDDProfiler::IsEnabled()) profiler->RecordStep(aStep);
+  NDDUserLimits::CheckStep(aStep);
+
   const G4String particleName =
       aStep->GetTrack()->GetDefinition()->GetParticleName();
 
@@ -30,24 +36,6 @@ void NDDSteppingAction::UserSteppingAction(const G4Step *aStep) {
                                   pVol->GetName());
   }
 
-  // if (pVol->GetName() == "Dead") {
-  //   eventAction->AddDepositedEnDead(aStep->GetTotalEnergyDeposit());
-  // } else if (pVol->GetName() == "EastFoil" || pVol->GetName() == "WestFoil") {
-  //   eventAction->AddDepositedEnFoil(aStep->GetTotalEnergyDeposit());
-  //   eventAction->SetFoilPoE(aStep->GetPreStepPoint()->GetPosition());
-  // } else if (pVol->GetName() == "Carrier") {
-  //   eventAction->AddDepositedEnCarrier(aStep->GetTotalEnergyDeposit());
-  // } else if (pVol->GetName() == "SourceHolder") {
-  //   eventAction->AddDepositedEnSourceHolder(aStep->GetTotalEnergyDeposit());
-  // else if (particleName == "gamma" &&
-  //            pVolPost->GetName() == "World") {
-  //   if (aStep->GetTrack()->GetCreatorProcess() &&
-  //       aStep->GetTrack()->GetCreatorProcess()->GetProcessName() == "eBrem") {
-  //       eventAction->AddBremsstrahlungLoss(aStep->GetPreStepPoint()->GetTotalEnergy());
-  //     aStep->GetTrack()->SetTrackStatus(fStopAndKill);
-  //   }
-  // }
-  //
   // if (particleName == "e-") {
   //   if (pVol->GetName() == "Dead" && pVolPost->GetName() == "World") {
   //     eventAction->SetAngleOut(
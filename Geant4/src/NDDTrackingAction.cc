@@ -0,0 +1,12 @@
+#include "NDDTrackingAction.hh"
+#include "NDDProfiler.hh"
+
+#include "G4Track.hh"
+
+NDDTrackingAction::NDDTrackingAction() : profiler(NDDProfiler::Instance()) {}
+
+NDDTrackingAction::~NDDTrackingAction() {}
+
+void NDDTrackingAction::PreUserTrackingAction(const G4Track* track) {
+  if (NDDProfiler::IsEnabled()) profiler->BeginTrack(track);
+}
@@ -0,0 +1,249 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDTrigger.hh"
+#include "NDDTriggerMessenger.hh"
+#include "NDDPixelMap.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <fstream>
+#include <sstream>
+
+G4double NDDTrigger::threshold = 0.;
+G4double NDDTrigger::noise = 0.;
+G4double NDDTrigger::window = 1. * us;
+G4bool NDDTrigger::neighbourReadout = true;
+std::vector<G4double> NDDTrigger::thresholds;
+std::vector<G4double> NDDTrigger::noises;
+NDDTriggerMessenger* NDDTrigger::messenger = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDTrigger::CreateMessenger() {
+  if (!messenger) messenger = new NDDTriggerMessenger();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDTrigger::DeleteMessenger() {
+  delete messenger;
+  messenger = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDTrigger::NDDTrigger() {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDTrigger::LoadThresholds(const G4String& filename) {
+  if (filename == "none") {
+    thresholds.clear();
+    noises.clear();
+    return true;
+  }
+
+  std::ifstream in(filename);
+  if (!in) {
+    G4cout << "ERROR: cannot open pixel thresholds " << filename << G4endl;
+    return false;
+  }
+
+  // pixels missing from the file keep the common settings, marked by -1
+  std::vector<G4double> t, n;
+  std::string line;
+  G4int nLines = 0;
+  while (std::getline(in, line)) {
+    size_t comment = line.find('#');
+    if (comment != std::string::npos) line.erase(comment);
+
+    std::istringstream iss(line);
+    G4int pixel;
+    G4double pixelThreshold, pixelNoise = -1.;
+    if (!(iss >> pixel)) continue;
+    if (!(iss >> pixelThreshold) || pixel < 1) {
+      G4cout << "ERROR: bad line in pixel thresholds " << filename << ": "
+             << line << G4endl;
+      return false;
+    }
+    iss >> pixelNoise;
+
+    if (pixel > (G4int)t.size()) {
+      t.resize(pixel, -1.);
+      n.resize(pixel, -1.);
+    }
+    t[pixel - 1] = pixelThreshold * keV;
+    n[pixel - 1] = pixelNoise >= 0 ? pixelNoise * keV : -1.;
+    nLines++;
+  }
+
+  thresholds.swap(t);
+  noises.swap(n);
+  G4cout << "Loaded thresholds of " << nLines << " pixels from " << filename
+         << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NDDTrigger::GetThreshold(G4int pixel) const {
+  if (pixel <= (G4int)thresholds.size() && thresholds[pixel - 1] >= 0) {
+    return thresholds[pixel - 1];
+  }
+  // a pixel without any threshold never triggers by itself
+  return threshold > 0 ? threshold : DBL_MAX;
+}
+
+G4double NDDTrigger::GetNoise(G4int pixel) const {
+  if (pixel <= (G4int)noises.size() && noises[pixel - 1] >= 0) {
+    return noises[pixel - 1];
+  }
+  return noise;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::vector<NDDTriggerRecord>& NDDTrigger::Process(
+    NDDSiPixelHitsCollection* hc, const std::vector<NDDPixelDeposit>* shared,
+    const std::vector<NDDPixelWaveform>* waveforms, G4double startTime) {
+  records.clear();
+  if (!IsEnabled() || hc->entries() == 0) return records;
+
+  G4int nPixels = std::max(NDDPixelMap::Instance()->GetNumberOfPixels(),
+                           (G4int)thresholds.size());
+  for (size_t i = 0; i < hc->entries(); i++) {
+    nPixels = std::max(nPixels, (*hc)[i]->GetPixelNumber());
+  }
+
+  noiseSample.resize(nPixels);
+  for (G4int p = 0; p < nPixels; p++) {
+    G4double sigma = GetNoise(p + 1);
+    noiseSample[p] = sigma > 0 ? G4RandGauss::shoot(0., sigma) : 0.;
+  }
+  energy.assign(nPixels, 0.);
+  time.assign(nPixels, DBL_MAX);
+  recorded.assign(nPixels, false);
+
+  G4double triggerTime;
+  if (waveforms) {
+    triggerTime = FromWaveforms(*waveforms, startTime);
+  } else {
+    sorted.clear();
+    if (shared) {
+      for (const NDDPixelDeposit& d : *shared) {
+        if (d.pixelNumber > 0 && d.pixelNumber <= nPixels) sorted.push_back(d);
+      }
+    } else {
+      for (size_t i = 0; i < hc->entries(); i++) {
+        const NDDSiPixelHit* hit = (*hc)[i];
+        if (hit->GetPixelNumber() < 1) continue;
+        sorted.push_back({hit->GetPixelNumber(), hit->GetEnDep(), hit->GetTime()});
+      }
+    }
+    triggerTime = FromDeposits();
+  }
+  if (triggerTime < DBL_MAX) Record(triggerTime);
+  return records;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NDDTrigger::FromDeposits() {
+  if (sorted.empty()) return DBL_MAX;
+  std::sort(sorted.begin(), sorted.end(),
+            [](const NDDPixelDeposit& a, const NDDPixelDeposit& b) {
+              return a.time < b.time;
+            });
+
+  // the first crossing of the cumulative energy decides the trigger;
+  // noise alone above threshold counts from the first hit
+  G4int nPixels = energy.size();
+  G4double triggerTime = DBL_MAX;
+  for (G4int p = 0; p < nPixels; p++) {
+    energy[p] = noiseSample[p];
+    if (energy[p] >= GetThreshold(p + 1)) triggerTime = sorted[0].time;
+  }
+  for (const NDDPixelDeposit& d : sorted) {
+    G4int p = d.pixelNumber - 1;
+    G4bool below = energy[p] < GetThreshold(p + 1);
+    energy[p] += d.eDep;
+    if (time[p] == DBL_MAX) time[p] = d.time;
+    if (below && energy[p] >= GetThreshold(p + 1)) {
+      time[p] = d.time;
+      triggerTime = std::min(triggerTime, d.time);
+    }
+  }
+  if (triggerTime == DBL_MAX) return triggerTime;
+
+  // only what arrives within the window is integrated
+  const G4double end = triggerTime + window;
+  energy.assign(noiseSample.begin(), noiseSample.end());
+  for (const NDDPixelDeposit& d : sorted) {
+    if (d.time >= end) break;
+    energy[d.pixelNumber - 1] += d.eDep;
+  }
+  return triggerTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NDDTrigger::FromWaveforms(
+    const std::vector<NDDPixelWaveform>& waveforms, G4double startTime) {
+  G4int nPixels = energy.size();
+  G4double triggerTime = DBL_MAX;
+  for (G4int p = 0; p < nPixels; p++) energy[p] = noiseSample[p];
+
+  // amplitudes are in keV equivalent, times from the start of the waveform
+  for (const NDDPixelWaveform& w : waveforms) {
+    G4int p = w.pixelNumber - 1;
+    if (p < 0 || p >= nPixels) continue;
+    energy[p] += w.features.amplitude * keV;
+    time[p] = startTime + w.features.time;
+    if (energy[p] >= GetThreshold(p + 1)) {
+      triggerTime = std::min(triggerTime, time[p]);
+    }
+  }
+  for (G4int p = 0; p < nPixels; p++) {
+    if (time[p] == DBL_MAX && energy[p] >= GetThreshold(p + 1)) {
+      triggerTime = std::min(triggerTime, startTime);
+    }
+  }
+  return triggerTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDTrigger::Record(G4double triggerTime) {
+  G4int nPixels = energy.size();
+  const G4double end = triggerTime + window;
+  for (G4int p = 0; p < nPixels; p++) {
+    if (energy[p] < GetThreshold(p + 1)) continue;
+    // a pixel with only noise is timed with the trigger
+    G4double t = time[p] == DBL_MAX ? triggerTime : time[p];
+    if (t >= end) continue;
+    records.push_back({p + 1, energy[p], t, true});
+    recorded[p] = true;
+  }
+  if (!neighbourReadout) return;
+
+  const NDDPixelMap* pixelMap = NDDPixelMap::Instance();
+  size_t nSelf = records.size();
+  for (size_t i = 0; i < nSelf; i++) {
+    if (records[i].pixelNumber > pixelMap->GetNumberOfPixels()) continue;
+    for (G4int neighbour : pixelMap->GetNeighbours(records[i].pixelNumber)) {
+      G4int q = neighbour - 1;
+      if (q >= nPixels || recorded[q]) continue;
+      // neighbours without signal in the window are timed with the trigger
+      G4double t = time[q] < end ? time[q] : triggerTime;
+      records.push_back({neighbour, energy[q], t, false});
+      recorded[q] = true;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,103 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDTriggerMessenger.hh"
+#include "NDDTrigger.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithABool.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDTriggerMessenger::NDDTriggerMessenger()
+    : G4UImessenger(),
+      triggerDir(0),
+      triggerThresholdCmd(0),
+      triggerThresholdsCmd(0),
+      triggerNoiseCmd(0),
+      triggerWindowCmd(0),
+      triggerNeighboursCmd(0) {
+  triggerDir = new G4UIdirectory("/NDD/trigger/");
+  triggerDir->SetGuidance("Trigger and readout emulation, see NDDTrigger.");
+  triggerDir->SetGuidance("Recorded pixels are written to the triggers ntuple.");
+
+  triggerThresholdCmd =
+      new G4UIcmdWithADoubleAndUnit("/NDD/trigger/threshold", this);
+  triggerThresholdCmd->SetGuidance("Threshold of every pixel, 0 to disable.");
+  triggerThresholdCmd->SetGuidance("Pixels in the thresholds file override it.");
+  triggerThresholdCmd->SetParameterName("threshold", false);
+  triggerThresholdCmd->SetRange("threshold>=0.");
+  triggerThresholdCmd->SetUnitCategory("Energy");
+  triggerThresholdCmd->SetDefaultUnit("keV");
+  triggerThresholdCmd->SetToBeBroadcasted(false);
+  triggerThresholdCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  triggerThresholdsCmd = new G4UIcmdWithAString("/NDD/trigger/thresholds", this);
+  triggerThresholdsCmd->SetGuidance(
+      "Per pixel thresholds, lines of 'pixel threshold [noise]' in keV.");
+  triggerThresholdsCmd->SetGuidance("'none' to go back to the common settings.");
+  triggerThresholdsCmd->SetParameterName("file", false);
+  triggerThresholdsCmd->SetToBeBroadcasted(false);
+  triggerThresholdsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  triggerNoiseCmd = new G4UIcmdWithADoubleAndUnit("/NDD/trigger/noise", this);
+  triggerNoiseCmd->SetGuidance("Gaussian noise of every pixel, as a sigma.");
+  triggerNoiseCmd->SetParameterName("noise", false);
+  triggerNoiseCmd->SetRange("noise>=0.");
+  triggerNoiseCmd->SetUnitCategory("Energy");
+  triggerNoiseCmd->SetDefaultUnit("keV");
+  triggerNoiseCmd->SetToBeBroadcasted(false);
+  triggerNoiseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  triggerWindowCmd = new G4UIcmdWithADoubleAndUnit("/NDD/trigger/window", this);
+  triggerWindowCmd->SetGuidance(
+      "Pixels crossing threshold this long after the trigger are recorded.");
+  triggerWindowCmd->SetParameterName("window", false);
+  triggerWindowCmd->SetRange("window>0.");
+  triggerWindowCmd->SetUnitCategory("Time");
+  triggerWindowCmd->SetDefaultUnit("ns");
+  triggerWindowCmd->SetToBeBroadcasted(false);
+  triggerWindowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  triggerNeighboursCmd = new G4UIcmdWithABool("/NDD/trigger/neighbours", this);
+  triggerNeighboursCmd->SetGuidance(
+      "Also read out the neighbours of triggered pixels.");
+  triggerNeighboursCmd->SetParameterName("flag", false);
+  triggerNeighboursCmd->SetToBeBroadcasted(false);
+  triggerNeighboursCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDTriggerMessenger::~NDDTriggerMessenger() {
+  delete triggerThresholdCmd;
+  delete triggerThresholdsCmd;
+  delete triggerNoiseCmd;
+  delete triggerWindowCmd;
+  delete triggerNeighboursCmd;
+  delete triggerDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDTriggerMessenger::SetNewValue(G4UIcommand* command,
+                                      G4String newValues) {
+  if (command == triggerThresholdCmd)
+    NDDTrigger::SetThreshold(triggerThresholdCmd->GetNewDoubleValue(newValues));
+
+  if (command == triggerThresholdsCmd) NDDTrigger::LoadThresholds(newValues);
+
+  if (command == triggerNoiseCmd)
+    NDDTrigger::SetNoise(triggerNoiseCmd->GetNewDoubleValue(newValues));
+
+  if (command == triggerWindowCmd)
+    NDDTrigger::SetWindow(triggerWindowCmd->GetNewDoubleValue(newValues));
+
+  if (command == triggerNeighboursCmd)
+    NDDTrigger::SetNeighbourReadout(
+        triggerNeighboursCmd->GetNewBoolValue(newValues));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
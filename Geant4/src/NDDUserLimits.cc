@@ -0,0 +1,213 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDUserLimits.hh"
+
+#include "G4AccumulableManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleTable.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+#include "G4ios.hh"
+
+#include <cfloat>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+std::vector<G4ThreeVector> NDDUserLimits::detectors;
+G4bool NDDUserLimits::timeOrEnergyLimited = false;
+G4bool NDDUserLimits::distanceLimited = false;
+
+namespace {
+std::map<G4String, NDDUserLimits*> limitsByVolume;
+
+// kills per reason and particle: e-/e+, gamma, proton, other
+const G4int nClasses = 4;
+const char* classNames[nClasses] = {"e-/e+", "gamma", "proton", "other"};
+const char* reasonNames[NDDUserLimits::kNumberOfReasons] = {
+    "time limit", "energy floor", "distance"};
+G4ThreadLocal G4Accumulable<G4long>*
+    kills[NDDUserLimits::kNumberOfReasons][nClasses];
+G4ThreadLocal G4Accumulable<G4double>*
+    killedEnergy[NDDUserLimits::kNumberOfReasons][nClasses];
+
+G4int ParticleClass(const G4Track* track) {
+  G4int pdg = std::abs(track->GetDefinition()->GetPDGEncoding());
+  if (pdg == 11) return 0;
+  if (pdg == 22) return 1;
+  if (pdg == 2212) return 2;
+  return 3;
+}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDUserLimits::NDDUserLimits(const G4String& volume, NDDUserLimits* g)
+    : G4UserLimits("NDDUserLimits/" + volume),
+      global(g),
+      maxTime(-1.),
+      maxDistance(-1.),
+      minEkinAll(-1.) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDUserLimits* NDDUserLimits::Get(const G4String& volume) {
+  auto it = limitsByVolume.find(volume);
+  if (it != limitsByVolume.end()) return it->second;
+
+  NDDUserLimits* global = volume == "all" ? nullptr : Get("all");
+  NDDUserLimits* limits = new NDDUserLimits(volume, global);
+  limitsByVolume[volume] = limits;
+  return limits;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NDDUserLimits::GetUserMaxTime(const G4Track& track) {
+  if (maxTime >= 0) return maxTime;
+  return global ? global->GetUserMaxTime(track) : DBL_MAX;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NDDUserLimits::GetUserMinEkin(const G4Track& track) {
+  if (!minEkin.empty()) {
+    auto it = minEkin.find(track.GetDefinition());
+    if (it != minEkin.end()) return it->second;
+  }
+  if (minEkinAll >= 0) return minEkinAll;
+  return global ? global->GetUserMinEkin(track) : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NDDUserLimits::GetMaxDistance() const {
+  if (maxDistance >= 0) return maxDistance;
+  return global ? global->GetMaxDistance() : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDUserLimits::SetMaxTime(G4double t) {
+  maxTime = t;
+  timeOrEnergyLimited = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NDDUserLimits::SetMinEkin(const G4String& particle, G4double e) {
+  if (particle == "all") {
+    minEkinAll = e;
+    if (e > 0) timeOrEnergyLimited = true;
+    return true;
+  }
+  const G4ParticleDefinition* definition =
+      G4ParticleTable::GetParticleTable()->FindParticle(particle);
+  if (!definition) {
+    G4cout << "ERROR: unknown particle " << particle << " for the energy floor"
+           << G4endl;
+    return false;
+  }
+  minEkin[definition] = e;
+  if (e > 0) timeOrEnergyLimited = true;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDUserLimits::SetMaxDistance(G4double d) {
+  maxDistance = d;
+  if (d > 0) distanceLimited = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDUserLimits::CheckStep(const G4Step* step) {
+  G4Track* track = step->GetTrack();
+  const G4StepPoint* pre = step->GetPreStepPoint();
+  const G4StepPoint* post = step->GetPostStepPoint();
+  NDDUserLimits* limits = dynamic_cast<NDDUserLimits*>(
+      pre->GetPhysicalVolume()->GetLogicalVolume()->GetUserLimits());
+  if (!limits) return;
+
+  // G4UserSpecialCuts stops the track with fStopButAlive, so the kill is
+  // told by the process rather than the track status
+  const G4VProcess* process = post->GetProcessDefinedStep();
+  if (process && process->GetProcessName() == "UserSpecialCut") {
+    G4double maxTime = limits->GetUserMaxTime(*track);
+    Reason reason =
+        post->GetGlobalTime() >= maxTime * (1. - 1e-9) ? kTime : kEnergy;
+    Record(reason, track, pre->GetKineticEnergy());
+    return;
+  }
+  if (track->GetTrackStatus() != fAlive) return;
+
+  if (!distanceLimited) return;
+  G4double maxDistance = limits->GetMaxDistance();
+  if (maxDistance <= 0) return;
+  if (detectors.empty()) return;
+  // beyond the distance from every detector and moving away from each
+  for (const G4ThreeVector& detector : detectors) {
+    G4ThreeVector r = post->GetPosition() - detector;
+    if (r.mag2() <= maxDistance * maxDistance ||
+        r.dot(post->GetMomentumDirection()) <= 0) {
+      return;
+    }
+  }
+  track->SetTrackStatus(fStopAndKill);
+  Record(kDistance, track, post->GetKineticEnergy());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDUserLimits::Record(Reason reason, const G4Track* track,
+                           G4double energy) {
+  G4int c = ParticleClass(track);
+  *kills[reason][c] += 1;
+  *killedEnergy[reason][c] += energy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDUserLimits::CreateAccumulables() {
+  // in the same order on every thread, the manager merges them by position
+  G4AccumulableManager* manager = G4AccumulableManager::Instance();
+  for (G4int r = 0; r < kNumberOfReasons; r++) {
+    for (G4int c = 0; c < nClasses; c++) {
+      std::ostringstream name;
+      name << "NDDKills_" << r << "_" << c;
+      kills[r][c] = manager->CreateAccumulable<G4long>(name.str(), 0);
+      killedEnergy[r][c] =
+          manager->CreateAccumulable<G4double>(name.str() + "_energy", 0.);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDUserLimits::Report() {
+  G4long total = 0;
+  for (G4int r = 0; r < kNumberOfReasons; r++) {
+    for (G4int c = 0; c < nClasses; c++) total += kills[r][c]->GetValue();
+  }
+  if (total == 0) return;
+
+  // number of tracks killed and their kinetic energy at the last step
+  G4cout << "Killed tracks:" << std::setw(14) << "";
+  for (G4int c = 0; c < nClasses; c++) G4cout << std::setw(12) << classNames[c];
+  G4cout << std::setw(16) << "energy [keV]" << G4endl;
+  for (G4int r = 0; r < kNumberOfReasons; r++) {
+    G4double energy = 0.;
+    G4cout << "  " << std::left << std::setw(26) << reasonNames[r] << std::right;
+    for (G4int c = 0; c < nClasses; c++) {
+      G4cout << std::setw(12) << kills[r][c]->GetValue();
+      energy += killedEnergy[r][c]->GetValue();
+    }
+    G4cout << std::setw(16) << energy / keV << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,210 @@
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NDDWaveformBatch.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NDDWaveformBatch::NDDWaveformBatch() : nWaveforms(0), nSamples(0), period(1.) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDWaveformBatch::Resize(G4int nw, G4int ns, G4double p) {
+  nWaveforms = nw;
+  nSamples = ns;
+  period = p;
+  data.assign((size_t)nw * ns, 0.);
+  state.resize(nw);
+  previous.resize(nw);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDWaveformBatch::SetWaveform(G4int w, const G4double* samples, G4int n) {
+  if (n <= 0) return;
+  for (G4int s = 0; s < nSamples; s++) {
+    data[(size_t)s * nWaveforms + w] = samples[std::min(s, n - 1)];
+  }
+}
+
+void NDDWaveformBatch::GetWaveform(G4int w, G4double* samples) const {
+  for (G4int s = 0; s < nSamples; s++) {
+    samples[s] = data[(size_t)s * nWaveforms + w];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDWaveformBatch::LowPass(G4double rc) {
+  if (nSamples == 0) return;
+  const G4double a = period / (rc + period);
+  G4double* y = &state[0];
+  std::copy(Sample(0), Sample(0) + nWaveforms, y);
+  for (G4int s = 1; s < nSamples; s++) {
+    G4double* x = Sample(s);
+    for (G4int w = 0; w < nWaveforms; w++) {
+      y[w] += a * (x[w] - y[w]);
+      x[w] = y[w];
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDWaveformBatch::HighPass(G4double rc) {
+  if (nSamples == 0) return;
+  const G4double b = rc / (rc + period);
+  G4double* y = &state[0];
+  G4double* xPrevious = &previous[0];
+  std::copy(Sample(0), Sample(0) + nWaveforms, y);
+  std::copy(Sample(0), Sample(0) + nWaveforms, xPrevious);
+  for (G4int s = 1; s < nSamples; s++) {
+    G4double* x = Sample(s);
+    for (G4int w = 0; w < nWaveforms; w++) {
+      y[w] = b * (y[w] + x[w] - xPrevious[w]);
+      xPrevious[w] = x[w];
+      x[w] = y[w];
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDWaveformBatch::Integrate() {
+  if (nSamples == 0) return;
+  std::fill(Sample(0), Sample(0) + nWaveforms, 0.);
+  for (G4int s = 1; s < nSamples; s++) {
+    G4double* x = Sample(s);
+    const G4double* y = Sample(s - 1);
+    for (G4int w = 0; w < nWaveforms; w++) x[w] = y[w] + x[w] * period;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDWaveformBatch::PoleZero(G4double decay) {
+  // undoes an exponential decay: u[n] = u[n-1] + x[n] - a x[n-1]
+  if (nSamples == 0 || decay <= 0) return;
+  const G4double a = std::exp(-period / decay);
+  G4double* xPrevious = &previous[0];
+  std::copy(Sample(0), Sample(0) + nWaveforms, xPrevious);
+  for (G4int s = 1; s < nSamples; s++) {
+    G4double* x = Sample(s);
+    const G4double* u = Sample(s - 1);
+    for (G4int w = 0; w < nWaveforms; w++) {
+      G4double xs = x[w];
+      x[w] = u[w] + xs - a * xPrevious[w];
+      xPrevious[w] = xs;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDWaveformBatch::Trapezoid(G4double rise, G4double flat) {
+  // d[n] = u[n] - u[n-k] - u[n-l] + u[n-k-l], summed once; a step of
+  // height A becomes a trapezoid of height k A, earlier samples are taken
+  // as the baseline u[0]
+  if (nSamples == 0) return;
+  const G4int k = std::max(1, (G4int)std::lround(rise / period));
+  const G4int l = k + std::max(0, (G4int)std::lround(flat / period));
+
+  copy = data;
+  const G4double* u = &copy[0];
+  auto input = [&](G4int s) { return u + (size_t)std::max(s, 0) * nWaveforms; };
+
+  G4double* sum = &state[0];
+  std::fill(sum, sum + nWaveforms, 0.);
+  const G4double norm = 1. / k;
+  for (G4int s = 0; s < nSamples; s++) {
+    const G4double* u0 = input(s);
+    const G4double* uk = input(s - k);
+    const G4double* ul = input(s - l);
+    const G4double* ukl = input(s - k - l);
+    G4double* y = Sample(s);
+    for (G4int w = 0; w < nWaveforms; w++) {
+      sum[w] += u0[w] - uk[w] - ul[w] + ukl[w];
+      y[w] = sum[w] * norm;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDWaveformBatch::Shape(const NDDShaping& shaping) {
+  switch (shaping.type) {
+    case NDDShaping::kCRRC: {
+      PoleZero(shaping.decay);
+      HighPass(shaping.tau);
+      for (G4int i = 0; i < shaping.order; i++) LowPass(shaping.tau);
+      // the peak of CR-RC^n for a unit step is n^n e^-n / n!
+      G4double gain = 1.;
+      for (G4int i = 1; i <= shaping.order; i++) {
+        gain *= shaping.order / (G4double)i;
+      }
+      gain *= std::exp(-(G4double)shaping.order);
+      for (G4double& x : data) x /= gain;
+      break;
+    }
+    case NDDShaping::kTrapezoid:
+      PoleZero(shaping.decay);
+      Trapezoid(shaping.rise, shaping.flat);
+      break;
+    case NDDShaping::kNone:
+      break;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NDDWaveformBatch::Extract(G4double low, G4double high,
+                               std::vector<NDDPulseFeatures>& features) {
+  features.resize(nWaveforms);
+  if (nSamples == 0) return;
+
+  amplitude.assign(Sample(0), Sample(0) + nWaveforms);
+  peak.assign(nWaveforms, 0.);
+  for (G4int s = 1; s < nSamples; s++) {
+    const G4double* x = Sample(s);
+    for (G4int w = 0; w < nWaveforms; w++) {
+      G4bool larger = x[w] > amplitude[w];
+      amplitude[w] = larger ? x[w] : amplitude[w];
+      peak[w] = larger ? s : peak[w];
+    }
+  }
+
+  // first crossings of both fractions, linear between samples; -1 until
+  // found, branch free so that it vectorizes
+  tLow.assign(nWaveforms, -1.);
+  tHigh.assign(nWaveforms, -1.);
+  for (G4int s = 1; s < nSamples; s++) {
+    const G4double* x0 = Sample(s - 1);
+    const G4double* x1 = Sample(s);
+    for (G4int w = 0; w < nWaveforms; w++) {
+      G4double lowLevel = low * amplitude[w], highLevel = high * amplitude[w];
+      G4double dx = x1[w] - x0[w];
+      G4bool crossLow = tLow[w] < 0 && x0[w] < lowLevel && x1[w] >= lowLevel;
+      G4bool crossHigh = tHigh[w] < 0 && x0[w] < highLevel && x1[w] >= highLevel;
+      G4double safe = dx > 0 ? dx : 1.;
+      tLow[w] = crossLow ? s - 1 + (lowLevel - x0[w]) / safe : tLow[w];
+      tHigh[w] = crossHigh ? s - 1 + (highLevel - x0[w]) / safe : tHigh[w];
+    }
+  }
+
+  for (G4int w = 0; w < nWaveforms; w++) {
+    NDDPulseFeatures& f = features[w];
+    f.amplitude = amplitude[w];
+    f.peakTime = peak[w] * period;
+    if (amplitude[w] > 0 && tLow[w] >= 0 && tHigh[w] >= 0) {
+      f.time = tLow[w] * period;
+      f.riseTime = (tHigh[w] - tLow[w]) * period;
+    } else {
+      f.time = f.riseTime = 0.;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
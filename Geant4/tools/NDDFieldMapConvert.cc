@@ -0,0 +1,173 @@
+// Converts a text field table into the binary map read by /NDD/field/map,
+// see NDDFieldMap for the format.
+//
+// The table has one point per line, blank lines and lines starting with
+// '#' or '%' are skipped:
+//
+//   r z Br Bz            axisymmetric map
+//   x y z Bx By Bz       3D map
+//
+// with positions in mm and fields in T, or kV/mm for the electric maps of
+// /NDD/field/electric/map, on a regular grid in any order.
+// The grid is taken from the distinct coordinates along each axis, which
+// must be evenly spaced and all present.
+//
+// usage: NDDFieldMapConvert <in.txt> <out.map> [--scale <factor>]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+
+// distinct coordinates, merging those closer than a small tolerance
+std::vector<double> Axis(std::vector<double> c) {
+  std::sort(c.begin(), c.end());
+  double tolerance = 1e-6 * std::max(1., std::fabs(c.back() - c.front()));
+  std::vector<double> axis;
+  for (double v : c) {
+    if (axis.empty() || v - axis.back() > tolerance) axis.push_back(v);
+  }
+  return axis;
+}
+
+bool Regular(const std::vector<double>& axis) {
+  if (axis.size() < 2) return true;
+  double step = (axis.back() - axis.front()) / (axis.size() - 1);
+  for (size_t i = 0; i < axis.size(); i++) {
+    if (std::fabs(axis[i] - axis.front() - i * step) > 1e-3 * step) return false;
+  }
+  return true;
+}
+
+int Index(const std::vector<double>& axis, double v) {
+  if (axis.size() < 2) return 0;
+  double step = (axis.back() - axis.front()) / (axis.size() - 1);
+  return (int)std::lround((v - axis.front()) / step);
+}
+
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "usage: NDDFieldMapConvert <in.txt> <out.map> [--scale factor]"
+              << std::endl;
+    return 1;
+  }
+
+  double scale = 1.;
+  for (int i = 3; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--scale" && i + 1 < argc) {
+      scale = std::atof(argv[++i]);
+    } else {
+      std::cerr << "ERROR: unknown option " << arg << std::endl;
+      return 1;
+    }
+  }
+
+  std::ifstream in(argv[1]);
+  if (!in) {
+    std::cerr << "ERROR: cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  // rows of (x, y, z, B...), y = 0 for axisymmetric tables
+  int columns = 0;
+  std::vector<std::vector<double>> rows;
+  std::string line;
+  for (int number = 1; std::getline(in, line); number++) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#' || line[first] == '%') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::vector<double> row;
+    double v;
+    while (fields >> v) row.push_back(v);
+    if (columns == 0) columns = row.size();
+    if ((columns != 4 && columns != 6) || (int)row.size() != columns) {
+      std::cerr << "ERROR: line " << number << " of " << argv[1]
+                << " has neither 4 (r z Br Bz) nor 6 (x y z Bx By Bz) columns"
+                << std::endl;
+      return 1;
+    }
+    if (columns == 4) row.insert(row.begin() + 1, 0.);
+    rows.push_back(row);
+  }
+  if (rows.empty()) {
+    std::cerr << "ERROR: no points in " << argv[1] << std::endl;
+    return 1;
+  }
+
+  int32_t dimension = columns == 4 ? 2 : 3;
+  int components = dimension == 2 ? 2 : 3;
+  std::vector<double> axes[3];
+  for (int a = 0; a < 3; a++) {
+    std::vector<double> c;
+    for (const auto& row : rows) c.push_back(row[a]);
+    axes[a] = Axis(c);
+    if (!Regular(axes[a]) || (axes[a].size() < 2 && !(dimension == 2 && a == 1))) {
+      std::cerr << "ERROR: the points along axis " << a
+                << " are not a regular grid" << std::endl;
+      return 1;
+    }
+  }
+
+  int32_t n[3] = {(int32_t)axes[0].size(), (int32_t)axes[1].size(),
+                  (int32_t)axes[2].size()};
+  size_t points = (size_t)n[0] * n[1] * n[2];
+  if (rows.size() != points) {
+    std::cerr << "ERROR: " << rows.size() << " points for a " << n[0] << "x"
+              << n[1] << "x" << n[2] << " grid" << std::endl;
+    return 1;
+  }
+
+  std::vector<float> values(points * components, 0.f);
+  std::vector<char> seen(points, 0);
+  for (const auto& row : rows) {
+    size_t p = ((size_t)Index(axes[0], row[0]) * n[1] + Index(axes[1], row[1])) *
+                   n[2] + Index(axes[2], row[2]);
+    if (seen[p]++) {
+      std::cerr << "ERROR: point (" << row[0] << ", " << row[1] << ", "
+                << row[2] << ") appears twice" << std::endl;
+      return 1;
+    }
+    for (int m = 0; m < components; m++) {
+      values[p * components + m] = (float)(row[3 + m] * scale);
+    }
+  }
+
+  double first[3], last[3];
+  for (int a = 0; a < 3; a++) {
+    first[a] = axes[a].front();
+    last[a] = axes[a].back();
+  }
+
+  std::ofstream out(argv[2], std::ios::binary);
+  out.write("NDDFMAP1", 8);
+  out.write((const char*)&dimension, sizeof(dimension));
+  out.write((const char*)n, sizeof(n));
+  out.write((const char*)first, sizeof(first));
+  out.write((const char*)last, sizeof(last));
+  out.write((const char*)&values[0], values.size() * sizeof(float));
+  if (!out) {
+    std::cerr << "ERROR: cannot write " << argv[2] << std::endl;
+    return 1;
+  }
+
+  std::cout << "Wrote " << (dimension == 2 ? "axisymmetric " : "") << n[0]
+            << "x" << (dimension == 2 ? "" : std::to_string(n[1]) + "x") << n[2]
+            << " field map to " << argv[2] << std::endl;
+  return 0;
+}
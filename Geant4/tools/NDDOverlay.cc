@@ -0,0 +1,511 @@
+// Overlays independently simulated events into continuous per-pixel streams
+// at a given source rate, to study pile-up without re-running transport.
+//
+// --rate is the rate of simulated source events: event iD arrives as the
+// (iD+1)-th event of a Poisson process, so events that are missing from the
+// input (no hits, or removed by the event filter or its prescale) still
+// take their time slot and pile-up follows the source rate, not the rate
+// of detected events. The iDs must count the simulated events, as Geant4
+// numbers them. Events dropped by a filter or prescale leave no pulses to
+// overlay, so such output underestimates pile-up: overlay unfiltered runs,
+// or those whose filter only rejects events that never reach a pixel.
+//
+// The digitized waveforms of every event (waveforms ntuple, see
+// /NDD/digitizer/) or its hits (hits or eventHits ntuple) are shifted by
+// its arrival time and merged into one time ordered stream per pixel,
+// which is cut into fixed-length readout frames:
+//
+//   waveforms  frames tree: pixelNumber, frame, startTime [ns], nEvents,
+//              samples. Only frames an event contributes to are written;
+//              earlier pulses hold their final charge, decaying with
+//              --decay if given, and show up as the baseline.
+//   hits       hits tree: the hits in time order per pixel, with the
+//              absolute time and the event; frames tree: pixelNumber,
+//              frame, startTime, nHits, nEvents, eDep [keV]. This needs
+//              the real pixelNumber column; hits files from before
+//              /NDD/output/ existed hold 0 there for every hit.
+//
+// The rows are grouped by event (iD) first, as the merged ntuple of an MT
+// run interleaves the rows of events simulated on different workers; the
+// events arrive in iD order. The index used for that takes 16 bytes per
+// input row; beyond it, only the stretch of each stream still open to later
+// events is kept in memory: hits are final once the next event arrives,
+// waveforms --margin before it (at least the digitizer pre-trigger).
+//
+// usage: NDDOverlay <in.root> <out.root> --rate <Hz> [options]
+//   --rate <Hz>      rate of simulated events, detected or not
+//   --frame <ns>     frame length (default 1000)
+//   --hits           overlay hits even if waveforms are present
+//   --decay <ns>     preamplifier decay of held pulses (default none)
+//   --margin <ns>    waveform start before the event time (default 1000)
+//   --seed <n>       of the arrival times (default 1)
+
+#include "G4Types.hh"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TTreeFormula.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+
+struct Options {
+  double rate = 0.;  // Hz
+  double frame = 1000.;
+  double decay = 0.;
+  double margin = 1000.;
+  unsigned long seed = 1;
+  bool hits = false;
+};
+
+// Poisson process of the simulated events, times in ns
+class ArrivalTimes {
+ public:
+  ArrivalTimes(double rate, unsigned long seed)
+      : engine(seed), meanGap(1e9 / rate), t(0.), n(0) {}
+  // time of event iD, the (iD+1)-th arrival; iDs in increasing order
+  double At(G4int iD) {
+    long long k = (long long)iD + 1 - n;
+    if (k > 0) {
+      // the sum of k exponential gaps
+      std::gamma_distribution<double> gaps((double)k, meanGap);
+      t += gaps(engine);
+      n += k;
+    }
+    return t;
+  }
+
+ private:
+  std::mt19937_64 engine;
+  double meanGap;
+  double t;
+  long long n;  // arrivals drawn so far
+};
+
+// the entries of the tree grouped by event, in iD order and in their
+// original order within an event
+std::vector<Long64_t> EventOrder(TTree* tree) {
+  TTreeFormula fID("iD", "iD", tree);
+  std::vector<std::pair<G4int, Long64_t>> keys;
+  keys.reserve(tree->GetEntries());
+  for (Long64_t entry = 0; entry < tree->GetEntries(); entry++) {
+    tree->LoadTree(entry);
+    keys.push_back(std::make_pair((G4int)fID.EvalInstance(0), entry));
+  }
+  std::sort(keys.begin(), keys.end());
+  std::vector<Long64_t> order;
+  order.reserve(keys.size());
+  for (const auto& k : keys) order.push_back(k.second);
+  return order;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class WaveformOverlay {
+ public:
+  WaveformOverlay(const Options& options, double p)
+      : period(p),
+        frameSamples(std::max(1LL, std::llround(options.frame / p))),
+        hold(options.decay > 0 ? std::exp(-p / options.decay) : 1.),
+        nFrames(0),
+        nPileUp(0),
+        nTruncated(0) {
+    frames = new TTree("frames", "Overlaid waveform frames");
+    frames->Branch("pixelNumber", &bPixel);
+    frames->Branch("frame", &bFrame);
+    frames->Branch("startTime", &bStart);
+    frames->Branch("nEvents", &bEvents);
+    frames->Branch("samples", &bSamples);
+  }
+
+  void Add(int pixelNumber, double t0, const std::vector<double>& v) {
+    if (v.empty()) return;
+    Long64_t n = v.size();
+    Long64_t s0 = std::llround(t0 / period);
+    Pixel& p = pixels[pixelNumber];
+
+    // idle pixels skip ahead to the frame of the pulse
+    Long64_t start = s0 - Modulo(s0);
+    if (p.samples.empty() && start > p.first) {
+      p.level *= std::pow(hold, (double)(start - p.first));
+      p.first = start;
+    }
+
+    if (s0 < p.first) nTruncated++;
+    if (s0 + n < p.first) {
+      p.level += v.back();
+      return;
+    }
+    size_t needed = s0 + n + 1 - p.first;
+    if (p.samples.size() < needed) {
+      p.samples.resize(needed, 0.);
+      p.steps.resize(needed, 0.);
+    }
+    for (Long64_t j = std::max(0LL, p.first - s0); j < n; j++) {
+      p.samples[s0 + j - p.first] += v[j];
+    }
+    // held from the sample after the pulse on
+    p.steps[s0 + n - p.first] += v.back();
+    p.events.push_back(std::make_pair(std::max(s0, p.first), s0 + n + 1));
+  }
+
+  // writes every frame that ends before time t
+  void Flush(double t) { FlushUntil((Long64_t)std::floor(t / period)); }
+
+  void Finish() {
+    FlushUntil(std::numeric_limits<Long64_t>::max() - frameSamples);
+  }
+
+  void Report() const {
+    std::cout << "Wrote " << nFrames << " frames, " << nPileUp
+              << " with more than one event";
+    if (nTruncated) std::cout << ", " << nTruncated << " pulses truncated";
+    std::cout << std::endl;
+  }
+
+  TTree* frames;
+
+ private:
+  struct Pixel {
+    Long64_t first = 0;  // sample index of the front of the deques
+    std::deque<double> samples, steps;
+    double level = 0.;   // held charge, at the sample before first
+    std::deque<std::pair<Long64_t, Long64_t> > events;  // [start, end)
+  };
+
+  void FlushUntil(Long64_t until) {
+    for (auto& entry : pixels) {
+      Pixel& p = entry.second;
+      while (!p.samples.empty() && p.first + frameSamples <= until) {
+        Emit(entry.first, p);
+      }
+    }
+  }
+
+  Long64_t Modulo(Long64_t s) const {
+    Long64_t m = s % frameSamples;
+    return m < 0 ? m + frameSamples : m;
+  }
+
+  void Emit(int pixelNumber, Pixel& p) {
+    if ((Long64_t)p.samples.size() < frameSamples) {
+      p.samples.resize(frameSamples, 0.);
+      p.steps.resize(frameSamples, 0.);
+    }
+    Long64_t last = p.first + frameSamples;
+
+    bEvents = 0;
+    for (auto& e : p.events) {
+      if (e.first < last && e.second > p.first) bEvents++;
+    }
+
+    bSamples.resize(frameSamples);
+    for (Long64_t i = 0; i < frameSamples; i++) {
+      p.level = p.level * hold + p.steps[i];
+      bSamples[i] = p.samples[i] + p.level;
+    }
+    if (bEvents > 0) {
+      bPixel = pixelNumber;
+      bFrame = p.first / frameSamples;
+      bStart = p.first * period;
+      frames->Fill();
+      nFrames++;
+      if (bEvents > 1) nPileUp++;
+    }
+
+    p.samples.erase(p.samples.begin(), p.samples.begin() + frameSamples);
+    p.steps.erase(p.steps.begin(), p.steps.begin() + frameSamples);
+    p.first = last;
+    while (!p.events.empty() && p.events.front().second <= p.first) {
+      p.events.pop_front();
+    }
+    // nothing pending: only zeros are left
+    if (p.events.empty()) {
+      p.samples.clear();
+      p.steps.clear();
+    }
+  }
+
+  double period;
+  Long64_t frameSamples;
+  double hold;
+  std::map<int, Pixel> pixels;
+
+  Long64_t nFrames, nPileUp, nTruncated;
+  int bPixel, bEvents;
+  Long64_t bFrame;
+  double bStart;
+  std::vector<double> bSamples;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class HitsOverlay {
+ public:
+  HitsOverlay(const Options& options)
+      : frameLength(options.frame), nHitsOut(0), nFrames(0), nPileUp(0) {
+    hits = new TTree("hits", "Overlaid hits, time ordered per pixel");
+    hits->Branch("iD", &hID);
+    hits->Branch("pixelNumber", &hPixel);
+    hits->Branch("time", &hTime);
+    hits->Branch("eDep", &hEDep);
+    frames = new TTree("frames", "Overlaid hit frames");
+    frames->Branch("pixelNumber", &fPixel);
+    frames->Branch("frame", &fFrame);
+    frames->Branch("startTime", &fStart);
+    frames->Branch("nHits", &fHits);
+    frames->Branch("nEvents", &fEvents);
+    frames->Branch("eDep", &fEDep);
+  }
+
+  void Add(int iD, int pixelNumber, double t, double eDep) {
+    Hit h = {t, eDep, iD};
+    pixels[pixelNumber].pending.push_back(h);
+  }
+
+  // hits before t are final, later events cannot precede them
+  void Flush(double t) {
+    for (auto& entry : pixels) {
+      Pixel& p = entry.second;
+      std::sort(p.pending.begin(), p.pending.end(),
+                [](const Hit& a, const Hit& b) { return a.time < b.time; });
+      size_t n = 0;
+      while (n < p.pending.size() && p.pending[n].time < t) {
+        Write(entry.first, p, p.pending[n]);
+        n++;
+      }
+      p.pending.erase(p.pending.begin(), p.pending.begin() + n);
+    }
+  }
+
+  void Finish() {
+    Flush(std::numeric_limits<double>::max());
+    for (auto& entry : pixels) CloseFrame(entry.first, entry.second);
+  }
+
+  void Report() const {
+    std::cout << "Wrote " << nHitsOut << " hits in " << nFrames << " frames, "
+              << nPileUp << " with more than one event" << std::endl;
+  }
+
+  TTree* hits;
+  TTree* frames;
+
+ private:
+  struct Hit {
+    double time, eDep;
+    int iD;
+  };
+  struct Pixel {
+    std::vector<Hit> pending;
+    Long64_t frame = -1;
+    int nHits = 0;
+    double eDep = 0.;
+    std::vector<int> events;
+  };
+
+  void Write(int pixelNumber, Pixel& p, const Hit& h) {
+    hID = h.iD;
+    hPixel = pixelNumber;
+    hTime = h.time;
+    hEDep = h.eDep;
+    hits->Fill();
+    nHitsOut++;
+
+    Long64_t frame = (Long64_t)std::floor(h.time / frameLength);
+    if (frame != p.frame) {
+      CloseFrame(pixelNumber, p);
+      p.frame = frame;
+    }
+    p.nHits++;
+    p.eDep += h.eDep;
+    if (std::find(p.events.begin(), p.events.end(), h.iD) == p.events.end()) {
+      p.events.push_back(h.iD);
+    }
+  }
+
+  void CloseFrame(int pixelNumber, Pixel& p) {
+    if (p.nHits > 0) {
+      fPixel = pixelNumber;
+      fFrame = p.frame;
+      fStart = p.frame * frameLength;
+      fHits = p.nHits;
+      fEvents = p.events.size();
+      fEDep = p.eDep;
+      frames->Fill();
+      nFrames++;
+      if (fEvents > 1) nPileUp++;
+    }
+    p.nHits = 0;
+    p.eDep = 0.;
+    p.events.clear();
+  }
+
+  double frameLength;
+  std::map<int, Pixel> pixels;
+  Long64_t nHitsOut, nFrames, nPileUp;
+
+  int hID, hPixel, fPixel, fHits, fEvents;
+  double hTime, hEDep, fStart, fEDep;
+  Long64_t fFrame;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool OverlayWaveforms(TTree* tree, const Options& options, TFile& out) {
+  Int_t iD = 0, pixelNumber = 0;
+  Double_t startTime = 0., period = 0.;
+  std::vector<double>* samples = nullptr;
+  tree->SetBranchAddress("iD", &iD);
+  tree->SetBranchAddress("pixelNumber", &pixelNumber);
+  tree->SetBranchAddress("startTime", &startTime);
+  tree->SetBranchAddress("samplePeriod", &period);
+  tree->SetBranchAddress("samples", &samples);
+  if (tree->GetEntries() == 0) return true;
+
+  tree->GetEntry(0);
+  out.cd();
+  WaveformOverlay overlay(options, period);
+  ArrivalTimes arrivals(options.rate, options.seed);
+
+  std::vector<Long64_t> order = EventOrder(tree);
+  G4int currentEvent = -1;
+  double t = 0.;
+  Long64_t nEvents = 0;
+  for (size_t i = 0; i < order.size(); i++) {
+    tree->GetEntry(order[i]);
+    if (!samples) continue;
+    if (iD != currentEvent || nEvents == 0) {
+      currentEvent = iD;
+      t = arrivals.At(iD);
+      nEvents++;
+      overlay.Flush(t - options.margin);
+    }
+    overlay.Add(pixelNumber, t + startTime, *samples);
+  }
+  overlay.Finish();
+
+  std::cout << nEvents << " events over " << t * 1e-9 << " s" << std::endl;
+  overlay.Report();
+  overlay.frames->Write();
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool OverlayHits(TTree* tree, const Options& options, TFile& out) {
+  if (!tree->GetBranch("time")) {
+    std::cerr << "ERROR: the hits have no time column, see "
+                 "/NDD/output/hitsColumns" << std::endl;
+    return false;
+  }
+  // quantized energies are in eV, as in SSD/ReadGeant4Hits.jl
+  TTreeFormula fID("iD", "iD", tree);
+  TTreeFormula fPixel("pixelNumber", "pixelNumber", tree);
+  TTreeFormula fTime("time", "time", tree);
+  TTreeFormula fEDep("eDep", tree->GetBranch("eDep") ? "eDep" : "eDep_q*0.001",
+                     tree);
+
+  out.cd();
+  HitsOverlay overlay(options);
+  ArrivalTimes arrivals(options.rate, options.seed);
+
+  std::vector<Long64_t> order = EventOrder(tree);
+  G4int currentEvent = -1;
+  double t = 0.;
+  Long64_t nEvents = 0;
+  for (size_t j = 0; j < order.size(); j++) {
+    tree->LoadTree(order[j]);
+    G4int iD = (G4int)fID.EvalInstance(0);
+    if (iD != currentEvent || nEvents == 0) {
+      currentEvent = iD;
+      t = arrivals.At(iD);
+      nEvents++;
+      overlay.Flush(t);
+    }
+    // one instance per row, or one per hit in the per-event layout
+    G4int n = fTime.GetNdata();
+    for (G4int i = 0; i < n; i++) {
+      overlay.Add(iD, (G4int)fPixel.EvalInstance(i), t + fTime.EvalInstance(i),
+                  fEDep.EvalInstance(i));
+    }
+  }
+  overlay.Finish();
+
+  std::cout << nEvents << " events over " << t * 1e-9 << " s" << std::endl;
+  overlay.Report();
+  overlay.hits->Write();
+  overlay.frames->Write();
+  return true;
+}
+
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "usage: NDDOverlay <in.root> <out.root> --rate <Hz>"
+              << " [--frame ns] [--hits] [--decay ns] [--margin ns] [--seed n]"
+              << std::endl;
+    return 1;
+  }
+
+  Options options;
+  for (G4int i = 3; i < argc; i++) {
+    std::string arg = argv[i];
+    G4bool one = i + 1 < argc;
+    if (arg == "--rate" && one) {
+      options.rate = std::atof(argv[++i]);
+    } else if (arg == "--frame" && one) {
+      options.frame = std::atof(argv[++i]);
+    } else if (arg == "--decay" && one) {
+      options.decay = std::atof(argv[++i]);
+    } else if (arg == "--margin" && one) {
+      options.margin = std::atof(argv[++i]);
+    } else if (arg == "--seed" && one) {
+      options.seed = std::strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "--hits") {
+      options.hits = true;
+    } else {
+      std::cerr << "ERROR: unknown option " << arg << std::endl;
+      return 1;
+    }
+  }
+  if (options.rate <= 0 || options.frame <= 0) {
+    std::cerr << "ERROR: --rate and --frame must be positive" << std::endl;
+    return 1;
+  }
+
+  TFile in(argv[1]);
+  if (!in.IsOpen()) return 1;
+  TTree* waveforms =
+      options.hits ? nullptr : (TTree*)in.Get("ntuple/waveforms");
+  TTree* hits = (TTree*)in.Get("ntuple/hits");
+  if (!hits) hits = (TTree*)in.Get("ntuple/eventHits");
+
+  TFile out(argv[2], "RECREATE");
+  G4bool ok = false;
+  if (waveforms && waveforms->GetEntries() > 0) {
+    ok = OverlayWaveforms(waveforms, options, out);
+  } else if (hits) {
+    ok = OverlayHits(hits, options, out);
+  } else {
+    std::cerr << "ERROR: no waveforms or hits ntuple in " << argv[1] << std::endl;
+  }
+  out.Close();
+  return ok ? 0 : 1;
+}
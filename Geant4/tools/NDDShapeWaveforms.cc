@@ -0,0 +1,191 @@
+// Shapes stored waveforms and extracts their amplitude and timing with the
+// same batched kernels as the digitizer (NDDWaveformBatch).
+//
+// Input is either the waveforms ntuple of an NDD output file, or a text file
+// with one waveform per line (samples separated by blanks, '#' comments), as
+// written by SSD. One CSV line of features per waveform goes to stdout.
+//
+// usage: NDDShapeWaveforms <file.root|file.txt> [options]
+//   --period <ns>                  sampling of text input (default 1)
+//   --crrc <tau ns> <n>            CR-RC^n shaping
+//   --trapezoid <rise ns> <flat ns> trapezoidal shaping
+//   --decay <ns>                   pole-zero correct a preamplifier decay
+//   --fractions <low> <high>       for time and rise time (default 0.1 0.9)
+//   --waveforms <file.txt>         also write the shaped waveforms
+
+#include "NDDWaveformBatch.hh"
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+
+const size_t batchSize = 1024;
+
+struct Stored {
+  G4int iD, pixelNumber;
+  G4double period;
+  std::vector<G4double> samples;
+};
+
+struct Options {
+  NDDShaping shaping;
+  G4double period = 1.;
+  G4double low = 0.1, high = 0.9;
+  std::string waveformFile;
+};
+
+// Waveforms of one batch must share their length and period
+void Process(std::vector<Stored>& stored, const Options& options,
+             NDDWaveformBatch& batch, std::ofstream& waveformsOut) {
+  if (stored.empty()) return;
+
+  batch.Resize(stored.size(), stored[0].samples.size(), stored[0].period);
+  for (size_t i = 0; i < stored.size(); i++) {
+    batch.SetWaveform(i, &stored[i].samples[0], stored[i].samples.size());
+  }
+  batch.Shape(options.shaping);
+
+  std::vector<NDDPulseFeatures> features;
+  batch.Extract(options.low, options.high, features);
+  for (size_t i = 0; i < stored.size(); i++) {
+    std::printf("%d,%d,%g,%g,%g,%g\n", stored[i].iD, stored[i].pixelNumber,
+                features[i].amplitude, features[i].time, features[i].peakTime,
+                features[i].riseTime);
+    if (waveformsOut.is_open()) {
+      batch.GetWaveform(i, &stored[i].samples[0]);
+      for (size_t s = 0; s < stored[i].samples.size(); s++) {
+        waveformsOut << (s ? " " : "") << stored[i].samples[s];
+      }
+      waveformsOut << "\n";
+    }
+  }
+  stored.clear();
+}
+
+void Add(Stored& w, std::vector<Stored>& stored, const Options& options,
+         NDDWaveformBatch& batch, std::ofstream& waveformsOut) {
+  if (!stored.empty() && (w.samples.size() != stored[0].samples.size() ||
+                          w.period != stored[0].period)) {
+    Process(stored, options, batch, waveformsOut);
+  }
+  stored.push_back(w);
+  if (stored.size() == batchSize) Process(stored, options, batch, waveformsOut);
+}
+
+G4bool ReadROOT(const char* filename, const Options& options,
+                NDDWaveformBatch& batch, std::ofstream& waveformsOut) {
+  TFile file(filename);
+  TTree* tree = file.IsOpen() ? (TTree*)file.Get("ntuple/waveforms") : nullptr;
+  if (!tree) {
+    std::cerr << "ERROR: no waveforms ntuple in " << filename << std::endl;
+    return false;
+  }
+
+  Int_t iD = 0, pixelNumber = 0;
+  Double_t period = 0.;
+  std::vector<double>* samples = nullptr;
+  tree->SetBranchAddress("iD", &iD);
+  tree->SetBranchAddress("pixelNumber", &pixelNumber);
+  tree->SetBranchAddress("samplePeriod", &period);
+  tree->SetBranchAddress("samples", &samples);
+
+  std::vector<Stored> stored;
+  for (Long64_t entry = 0; entry < tree->GetEntries(); entry++) {
+    tree->GetEntry(entry);
+    if (!samples || samples->empty()) continue;
+    Stored w = {iD, pixelNumber, period, *samples};
+    Add(w, stored, options, batch, waveformsOut);
+  }
+  Process(stored, options, batch, waveformsOut);
+  return true;
+}
+
+G4bool ReadText(const char* filename, const Options& options,
+                NDDWaveformBatch& batch, std::ofstream& waveformsOut) {
+  std::ifstream in(filename);
+  if (!in) {
+    std::cerr << "ERROR: cannot open " << filename << std::endl;
+    return false;
+  }
+
+  std::vector<Stored> stored;
+  std::string line;
+  G4int n = 0;
+  while (std::getline(in, line)) {
+    size_t comment = line.find('#');
+    if (comment != std::string::npos) line.erase(comment);
+    Stored w = {n, 0, options.period, std::vector<G4double>()};
+    std::istringstream values(line);
+    G4double v;
+    while (values >> v) w.samples.push_back(v);
+    if (w.samples.empty()) continue;
+    Add(w, stored, options, batch, waveformsOut);
+    n++;
+  }
+  Process(stored, options, batch, waveformsOut);
+  return true;
+}
+
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "usage: NDDShapeWaveforms <file.root|file.txt> [--period ns]"
+              << " [--crrc tau n | --trapezoid rise flat] [--decay ns]"
+              << " [--fractions low high] [--waveforms out.txt]" << std::endl;
+    return 1;
+  }
+
+  Options options;
+  options.shaping = {NDDShaping::kNone, 0., 0, 0., 0., 0.};
+  for (G4int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    G4bool one = i + 1 < argc, two = i + 2 < argc;
+    if (arg == "--period" && one) {
+      options.period = std::atof(argv[++i]);
+    } else if (arg == "--crrc" && two) {
+      options.shaping.type = NDDShaping::kCRRC;
+      options.shaping.tau = std::atof(argv[++i]);
+      options.shaping.order = std::atoi(argv[++i]);
+    } else if (arg == "--trapezoid" && two) {
+      options.shaping.type = NDDShaping::kTrapezoid;
+      options.shaping.rise = std::atof(argv[++i]);
+      options.shaping.flat = std::atof(argv[++i]);
+    } else if (arg == "--decay" && one) {
+      options.shaping.decay = std::atof(argv[++i]);
+    } else if (arg == "--fractions" && two) {
+      options.low = std::atof(argv[++i]);
+      options.high = std::atof(argv[++i]);
+    } else if (arg == "--waveforms" && one) {
+      options.waveformFile = argv[++i];
+    } else {
+      std::cerr << "ERROR: unknown option " << arg << std::endl;
+      return 1;
+    }
+  }
+
+  std::ofstream waveformsOut;
+  if (!options.waveformFile.empty()) waveformsOut.open(options.waveformFile);
+
+  NDDWaveformBatch batch;
+  std::printf("iD,pixelNumber,amplitude,time,peakTime,riseTime\n");
+  size_t length = std::strlen(argv[1]);
+  G4bool ok = length > 5 && std::strcmp(argv[1] + length - 5, ".root") == 0
+                  ? ReadROOT(argv[1], options, batch, waveformsOut)
+                  : ReadText(argv[1], options, batch, waveformsOut);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Guiding-centre transport against full RK4 tracking.
+
+Writes the magnetic bottle of guidingCentre.mac, converts it with
+NDDFieldMapConvert and runs the macro once with full tracking and once with
+/NDD/guidingCentre/enable, from the same seeds. The two runs are compared
+on the electrons reaching the silicon:
+
+  - the fraction of events that reach it, which the mirror decides,
+  - the distributions of their arrival time (time of flight), radius of
+    the point of entry and deposited energy, with two-sample
+    Kolmogorov-Smirnov tests.
+
+Exits non-zero when any comparison fails. Needs numpy and uproot.
+
+    python3 check_guiding_centre.py --exe ./NDD --events 5000
+"""
+
+import argparse
+import math
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+try:
+    import numpy as np
+    import uproot
+except ImportError:
+    sys.exit("check_guiding_centre.py needs numpy and uproot")
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# Magnetic bottle, see guidingCentre.mac
+B0 = 1.       # T, at the source and the detector
+B_PEAK = 2.   # T
+Z_PEAK = -1000.  # mm
+WIDTH = 300.  # mm
+
+
+def write_bottle(path):
+    """r z Br Bz table in mm and T; Br to first order in r from div B = 0."""
+    with open(path, "w") as f:
+        f.write("# r z Br Bz, magnetic bottle for guidingCentre.mac\n")
+        for r in np.arange(0., 400. + 1e-9, 5.):
+            for z in np.arange(-2500., 500. + 1e-9, 10.):
+                u = (z - Z_PEAK) / WIDTH
+                bump = (B_PEAK - B0) * math.exp(-u * u)
+                bz = B0 + bump
+                dbz = -2. * u / WIDTH * bump
+                br = -0.5 * r * dbz
+                f.write("{:g} {:g} {:.9g} {:.9g}\n".format(r, z, br, bz))
+
+
+def run(exe, workdir, field_map, enable, args):
+    name = "guidingCentre" if enable else "fullTracking"
+    macro = os.path.join(workdir, name + ".mac")
+    with open(macro, "w") as f:
+        f.write("/control/verbose 0\n")
+        f.write("/run/verbose 1\n")
+        f.write("/run/numberOfThreads {}\n".format(args.threads))
+        f.write("/random/setSeeds {} {}\n".format(args.seed, args.seed + 1))
+        f.write("/control/alias fieldMap {}\n".format(field_map))
+        f.write("/control/alias gcEnable {}\n".format("true" if enable else "false"))
+        f.write("/control/alias output {}\n".format(name))
+        f.write("/control/execute {}\n".format(os.path.join(HERE, "guidingCentre.mac")))
+        f.write("/run/printProgress 0\n")
+        f.write("/run/beamOn {}\n".format(args.events))
+
+    log = os.path.join(workdir, name + ".log")
+    with open(log, "w") as out:
+        status = subprocess.call([exe, macro], cwd=workdir, stdout=out,
+                                 stderr=subprocess.STDOUT)
+    if status != 0:
+        sys.exit("NDD failed with status {}, see {}".format(status, log))
+
+    with open(log) as f:
+        real = re.findall(r"Real=([0-9.eE+-]+)s", f.read())
+    seconds = float(real[-1]) if real else float("nan")
+
+    with uproot.open(os.path.join(workdir, name + ".root")) as f:
+        energy = f["ntuple/energy"].arrays(["iD", "enSi"], library="np")
+        space = f["ntuple/spaceTime"].arrays(["iD", "timeSi", "poeXSi", "poeYSi"],
+                                             library="np")
+
+    # the merged ntuples interleave the workers' rows, join them on iD
+    order = np.argsort(energy["iD"])
+    enSi = energy["enSi"][order]
+    order = np.argsort(space["iD"])
+    timeSi = space["timeSi"][order]
+    radius = np.hypot(space["poeXSi"][order], space["poeYSi"][order])
+    hit = enSi > 0
+    return {
+        "name": name,
+        "seconds": seconds,
+        "events": len(enSi),
+        "hits": int(hit.sum()),
+        "timeSi": timeSi[hit],
+        "radius": radius[hit],
+        "enSi": enSi[hit],
+    }
+
+
+def ks_test(a, b):
+    """Two-sample Kolmogorov-Smirnov statistic and asymptotic p-value."""
+    a = np.sort(a)
+    b = np.sort(b)
+    x = np.concatenate([a, b])
+    d = np.max(np.abs(np.searchsorted(a, x, side="right") / len(a) -
+                      np.searchsorted(b, x, side="right") / len(b)))
+    ne = math.sqrt(len(a) * len(b) / float(len(a) + len(b)))
+    lam = (ne + 0.12 + 0.11 / ne) * d
+    p = 2. * sum((-1) ** (k - 1) * math.exp(-2. * k * k * lam * lam)
+                 for k in range(1, 101))
+    return d, min(max(p, 0.), 1.)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--exe", required=True, help="NDD executable")
+    parser.add_argument("--convert",
+                        help="NDDFieldMapConvert, by default next to --exe")
+    parser.add_argument("--events", type=int, default=5000)
+    parser.add_argument("--threads", type=int, default=1)
+    parser.add_argument("--seed", type=int, default=12345)
+    parser.add_argument("--alpha", type=float, default=1e-3,
+                        help="significance at which a comparison fails")
+    parser.add_argument("--keep", action="store_true",
+                        help="keep the work directory with the outputs")
+    args = parser.parse_args()
+
+    exe = os.path.abspath(args.exe)
+    convert = os.path.abspath(args.convert or os.path.join(os.path.dirname(exe),
+                                                           "NDDFieldMapConvert"))
+    workdir = tempfile.mkdtemp(prefix="ndd_guiding_centre_")
+    try:
+        table = os.path.join(workdir, "bottle.txt")
+        field_map = os.path.join(workdir, "bottle.map")
+        write_bottle(table)
+        subprocess.check_call([convert, table, field_map])
+
+        full = run(exe, workdir, field_map, False, args)
+        fast = run(exe, workdir, field_map, True, args)
+    finally:
+        if args.keep:
+            print("Outputs kept in {}".format(workdir))
+        else:
+            shutil.rmtree(workdir, ignore_errors=True)
+
+    failed = False
+    print("{:>14} {:>8} {:>8} {:>10} {:>12}".format(
+        "", "events", "hits", "fraction", "loop s"))
+    for r in (full, fast):
+        print("{:>14} {:>8} {:>8} {:>10.4f} {:>12.2f}".format(
+            r["name"], r["events"], r["hits"], r["hits"] / float(r["events"]),
+            r["seconds"]))
+    if full["seconds"] > 0 and fast["seconds"] > 0:
+        print("speedup {:.1f}x".format(full["seconds"] / fast["seconds"]))
+
+    # fraction reaching the silicon, normal approximation of two binomials
+    p1 = full["hits"] / float(full["events"])
+    p2 = fast["hits"] / float(fast["events"])
+    p = (full["hits"] + fast["hits"]) / float(full["events"] + fast["events"])
+    sigma = math.sqrt(p * (1. - p) * (1. / full["events"] + 1. / fast["events"]))
+    z = (p2 - p1) / sigma if sigma > 0 else 0.
+    p_value = math.erfc(abs(z) / math.sqrt(2.))
+    status = "ok" if p_value >= args.alpha else "FAILED"
+    failed |= status != "ok"
+    print("{:>14}: {:+.4f} ({:+.1f} sigma)  p = {:.3g}  {}".format(
+        "fraction", p2 - p1, z, p_value, status))
+
+    if full["hits"] == 0 or fast["hits"] == 0:
+        print("No electrons reached the silicon, nothing to compare")
+        return 1
+
+    for column, unit in (("timeSi", "ns"), ("radius", "mm"), ("enSi", "keV")):
+        d, p_value = ks_test(full[column], fast[column])
+        status = "ok" if p_value >= args.alpha else "FAILED"
+        failed |= status != "ok"
+        print("{:>14}: mean {:.4g} vs {:.4g} {}  KS D = {:.4f}  p = {:.3g}  {}".format(
+            column, np.mean(full[column]), np.mean(fast[column]), unit, d,
+            p_value, status))
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,72 @@
+using SolidStateDetectors
+using Unitful
+
+# Writes the pulse template library read by the Geant4 digitizer
+# (/NDD/digitizer/templates, format documented in
+# Geant4/include/NDDPulseTemplates.hh) by simulating one point deposit per
+# grid node with simulate!. origin, flipZ and thickness are as for
+# ExportResponseMap; rMax is in mm and should cover the neighbouring pixels.
+#
+# Templates are scaled so that a deposit under the pixel centre ends at 1,
+# i.e. the waveforms are in keV equivalent. Only angles 0-30 deg are
+# simulated, the digitizer folds the rest with the hexagonal symmetry.
+
+T = Float32
+
+function ExportPulseTemplates(filename::String, simulation::Simulation{T}, contact::Integer,
+    origin::CartesianPoint{T}; thickness = 2.0, rMax = 12.0, nDepth = 21, nRadius = 25,
+    nAngle = 4, period = 1.0, nSamples = 400, flipZ = false, time_step = 0.1u"ns")
+
+    depths = range(0, thickness, length = nDepth)
+    radii = range(0, rMax, length = nRadius)
+    angles = nAngle > 1 ? range(0, π / 6, length = nAngle) : [0.0]
+    zsign = flipZ ? -1 : 1
+    times = (0:nSamples-1) .* period
+
+    templates = Vector{Vector{T}}()
+    for depth in depths, r in radii, φ in angles
+        point = CartesianPoint{T}(origin[1] + r * cos(φ) / 1000, origin[2] + r * sin(φ) / 1000,
+                                  origin[3] + zsign * depth / 1000)
+        push!(templates, in(point, simulation.detector) ?
+              PointTemplate(simulation, contact, point, times, time_step) : zeros(T, nSamples))
+    end
+
+    # the deposit under the pixel centre, half way through the silicon
+    reference = templates[((nDepth ÷ 2) * nRadius) * length(angles) + 1][end]
+    reference == 0 && error("No signal under the pixel centre, check origin")
+
+    open(filename, "w") do io
+        println(io, "# exported from SSD, contact $contact")
+        println(io, "period $period")
+        println(io, "grid $nDepth $nRadius $(length(angles)) $nSamples")
+        println(io, "depth 0.0 $thickness")
+        println(io, "radius $rMax")
+        for t in templates
+            println(io, join(t ./ reference, " "))
+        end
+    end
+    @info "$(length(templates)) pulse templates written to $filename"
+end
+
+# Waveform of one point deposit, linearly resampled at times [ns]
+function PointTemplate(simulation::Simulation{T}, contact::Integer, point::CartesianPoint{T},
+    times, time_step)::Vector{T}
+    event = Event([point], [T(1)] * u"keV")
+    simulate!(event, simulation, Δt = time_step)
+    wf = event.waveforms[contact]
+    t = ustrip.(u"ns", collect(wf.time))
+    s = ustrip.(collect(wf.signal))
+    out = Vector{T}(undef, length(times))
+    for (i, τ) in enumerate(times)
+        j = searchsortedlast(t, τ)
+        if j == 0
+            out[i] = 0
+        elseif j >= length(t)
+            out[i] = s[end]
+        else
+            f = (τ - t[j]) / (t[j+1] - t[j])
+            out[i] = (1 - f) * s[j] + f * s[j+1]
+        end
+    end
+    return out
+end
@@ -0,0 +1,59 @@
+using SolidStateDetectors
+using Unitful
+
+# Writes the pixel response map read by the Geant4 digitizer
+# (/NDD/digitizer/map, format documented in
+# Geant4/include/NDDPixelResponseMap.hh) from a simulation with its electric
+# field, weighting potentials and drift model calculated, e.g. by
+# CalculateDefaultDetectorFields!.
+#
+# origin is the point of the SSD world [m] that corresponds to the origin of
+# the Geant4 pixel frame: the centre of the pixel on the front face of the
+# silicon. z runs into the silicon in both frames unless flipZ is set.
+# halfWidth and thickness are in mm, the map covers the square of
+# half-width halfWidth around the pixel and the full depth.
+#
+# collected is the carrier drifting to the pixel side, :h for the usual
+# p+ pixels on n-type silicon. The simulation grid is taken to be Cartesian,
+# as for the hexagonal pixel configurations.
+
+T = Float32
+
+function ExportResponseMap(filename::String, simulation::Simulation{T}, contact::Integer,
+    origin::CartesianPoint{T}; halfWidth = 10.0, thickness = 2.0, nx = 41, ny = 41, nz = 41,
+    pixelSide = "zmax", collected = :h, flipZ = false, time_step = 0.1u"ns")
+
+    wp = SolidStateDetectors.interpolated_scalarfield(simulation.weighting_potentials[contact])
+    xs = range(-halfWidth, halfWidth, length = nx)
+    ys = range(-halfWidth, halfWidth, length = ny)
+    zs = range(0, thickness, length = nz)
+    zsign = flipZ ? -1 : 1
+
+    open(filename, "w") do io
+        println(io, "# exported from SSD, contact $contact")
+        println(io, "pixelSide $pixelSide")
+        println(io, "grid $nx $ny $nz")
+        println(io, "range $(-halfWidth) $halfWidth $(-halfWidth) $halfWidth 0.0 $thickness")
+        for x in xs, y in ys
+            # one drift per point of the column, all at once
+            points = [CartesianPoint{T}(origin[1] + x / 1000, origin[2] + y / 1000,
+                                        origin[3] + zsign * z / 1000) for z in zs]
+            w = [in(p, simulation.detector) ? T(wp(p[1], p[2], p[3])) : zero(T) for p in points]
+            tc, to = DriftTimes(simulation, points, collected, time_step)
+            for iz in 1:nz
+                println(io, "$(w[iz]) $(tc[iz]) $(to[iz])")
+            end
+        end
+    end
+    @info "Response map written to $filename"
+end
+
+# Time [ns] until each carrier type stops, from the drift paths of SSD
+function DriftTimes(simulation::Simulation{T}, points::Vector{CartesianPoint{T}},
+    collected::Symbol, time_step)
+    energies = fill(T(1), length(points)) * u"keV"
+    paths = SolidStateDetectors.drift_charges(simulation, points, energies, Δt = time_step)
+    te = [ustrip(u"ns", p.timestamps_e[end]) for p in paths]
+    th = [ustrip(u"ns", p.timestamps_h[end]) for p in paths]
+    return collected == :h ? (th, te) : (te, th)
+end
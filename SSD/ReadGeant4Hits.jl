@@ -13,16 +13,44 @@ function GetHitInformation(filename::String)::Union{Nothing, GroupedDataFrame}
     return nothing
 end
 
+# Quantized hits columns (/NDD/output/hitsPrecision quantized) are integers
+# with a "_q" suffix, see NDDAnalysis.hh
+const positionQuantum = 1e-4 # mm
+const energyQuantum = 1e-3 # keV
+
+# Reads a real-valued column stored as double, float or quantized integer
+function ReadHitsColumn(has::Function, get::Function, name::String,
+                        quantum::Float64)::Array{Float64, 1}
+    if has(name)
+        return Float64.(get(name))
+    end
+    return quantum .* Float64.(get(name * "_q"))
+end
+
+# Index of the detector of every hit (/NDD/geometry/addDetector order), 0
+# for files written before the detector column existed
+function ReadDetectorColumn(has::Function, get::Function, n::Integer)::Array{Int64, 1}
+    return has("detector") ? Int64.(get("detector")) : zeros(Int64, n)
+end
+
 function GetHDF5HitInformation(filename::String)::GroupedDataFrame
     @info "Reading Geant4 Hits info from HDF5"
     fid = h5open(filename, "r")
-    id::Array{Int64, 1} = read(fid, "ntuple/hits/iD/pages")
-    x::Array{Float64, 1} = read(fid, "ntuple/hits/x/pages")
-    y::Array{Float64, 1} = read(fid, "ntuple/hits/y/pages")
-    z::Array{Float64, 1} = read(fid, "ntuple/hits/z/pages")
-    eDep::Array{Float64, 1} = read(fid, "ntuple/hits/eDep/pages")
+    if haskey(fid, "ntuple/eventHits")
+        has = name -> haskey(fid, "ntuple/eventHits/$name")
+        get = name -> read(fid, "ntuple/eventHits/$name/pages")
+        return GetEventHitInformation(has, get)
+    end
+    has = name -> haskey(fid, "ntuple/hits/$name")
+    get = name -> read(fid, "ntuple/hits/$name/pages")
+    id::Array{Int64, 1} = get("iD")
+    x = ReadHitsColumn(has, get, "x", positionQuantum)
+    y = ReadHitsColumn(has, get, "y", positionQuantum)
+    z = ReadHitsColumn(has, get, "z", positionQuantum)
+    eDep = ReadHitsColumn(has, get, "eDep", energyQuantum)
 
-    df = DataFrame(ID = id, X = x, Y = y, Z = z, E = eDep)
+    df = DataFrame(ID = id, X = x, Y = y, Z = z, E = eDep,
+                   Detector = ReadDetectorColumn(has, get, length(id)))
 
     return groupby(df, :ID)
 end
@@ -31,9 +59,71 @@ function GetROOTHitInformation(filename::String)::GroupedDataFrame
     # Functional, but might be crappy performance. Might look into lazy evaluation?
     @info "Reading Geant4 Hits info from ROOT $filename"
     file = TFile(filename)
+    # keys(file) carry ";1" cycle suffixes, so look the tree up directly
+    eventHits = try
+        file["ntuple/eventHits"]
+    catch
+        nothing
+    end
+    if !isnothing(eventHits)
+        return GetROOTEventHitInformation(eventHits)
+    end
     t = file["ntuple/hits"]
+    has = name -> name in keys(t)
+    get = name -> getproperty(t, Symbol(name))
 
-    df = DataFrame(ID = t.iD, X = t.x, Y = t.y, Z = t.z, E = t.eDep)
+    df = DataFrame(ID = t.iD,
+                   X = ReadHitsColumn(has, get, "x", positionQuantum),
+                   Y = ReadHitsColumn(has, get, "y", positionQuantum),
+                   Z = ReadHitsColumn(has, get, "z", positionQuantum),
+                   E = ReadHitsColumn(has, get, "eDep", energyQuantum),
+                   Detector = ReadDetectorColumn(has, get, length(t.iD)))
 
     return groupby(df, :ID)
 end
+
+# Per-event layout (/NDD/output/hitsLayout events): one entry per event in
+# ntuple/eventHits, with iD and nHits scalars and vector columns per hit.
+# Events are contiguous, so no sorting is needed and single events can be
+# read by entry number.
+
+function GetROOTEventHitInformation(t)::GroupedDataFrame
+    has = name -> name in keys(t)
+    get = name -> getproperty(t, Symbol(name))
+    return GetEventHitInformation(has, get)
+end
+
+# `get` returns a column with one entry per event, a vector for per-hit columns
+function GetEventHitInformation(has::Function, get::Function)::GroupedDataFrame
+    id = reduce(vcat, [fill(i, n) for (i, n) in zip(get("iD"), get("nHits"))])
+    hits = name -> reduce(vcat, get(name))
+
+    df = DataFrame(ID = id,
+                   X = ReadHitsColumn(has, hits, "x", positionQuantum),
+                   Y = ReadHitsColumn(has, hits, "y", positionQuantum),
+                   Z = ReadHitsColumn(has, hits, "z", positionQuantum),
+                   E = ReadHitsColumn(has, hits, "eDep", energyQuantum),
+                   Detector = ReadDetectorColumn(has, hits, length(id)))
+
+    return groupby(df, :ID, sort = false)
+end
+
+function OpenEventHits(filename::String)
+    return TFile(filename)["ntuple/eventHits"]
+end
+
+GetNumberOfEvents(t)::Int = length(t)
+
+# Hits of the event stored in entry `entry` (1-based) of an eventHits tree
+function GetEventHits(t, entry::Integer)::DataFrame
+    row = t[entry]
+    has = name -> haskey(row, Symbol(name))
+    get = name -> row[Symbol(name)]
+
+    return DataFrame(ID = fill(row.iD, row.nHits),
+                     X = ReadHitsColumn(has, get, "x", positionQuantum),
+                     Y = ReadHitsColumn(has, get, "y", positionQuantum),
+                     Z = ReadHitsColumn(has, get, "z", positionQuantum),
+                     E = ReadHitsColumn(has, get, "eDep", energyQuantum),
+                     Detector = ReadDetectorColumn(has, get, row.nHits))
+end
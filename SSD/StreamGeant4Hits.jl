@@ -0,0 +1,107 @@
+using Mmap
+using DataFrames
+
+# Consumer of the shared-memory hits stream written by Geant4 with
+# /NDD/output/stream <name>. The layout is documented in
+# Geant4/include/NDDHitStream.hh; offsets below are 0-based byte offsets.
+
+const streamHeaderSize = 64
+const paddingRecord = 0xFFFFFFFF
+const endOfRunRecord = 0xFFFFFFFE
+
+struct HitStream
+    buffer::Vector{UInt8}
+    capacity::UInt64
+end
+
+function OpenHitStream(name::String; timeout = 60.0)::HitStream
+    path = joinpath("/dev/shm", lstrip(name, '/'))
+    start = time()
+    while !isfile(path)
+        time() - start > timeout && error("No hits stream at $path")
+        sleep(0.1)
+    end
+    buffer = Mmap.mmap(path, Vector{UInt8}, filesize(path); shared = true)
+    String(buffer[1:8]) == "NDDHITS2" || error("$path is not a hits stream")
+    capacity = ReadHeader(buffer, UInt64, 16)
+    return HitStream(buffer, capacity)
+end
+
+function ReadHeader(buffer::Vector{UInt8}, ::Type{S}, offset::Integer) where S
+    Threads.atomic_fence()
+    return unsafe_load(Ptr{S}(pointer(buffer, offset + 1)))
+end
+
+function WriteReadOffset(stream::HitStream, offset::UInt64)
+    Threads.atomic_fence()
+    unsafe_store!(Ptr{UInt64}(pointer(stream.buffer, 33)), offset)
+end
+
+# Returns the hits of the next event as a DataFrame with the columns of
+# GetHitInformation, or nothing once the producer has closed the stream.
+# Blocks while Geant4 is still running and no event is available.
+function NextEvent(stream::HitStream; endOfRun = false)::Union{Nothing, DataFrame}
+    buffer = stream.buffer
+    while true
+        read = ReadHeader(buffer, UInt64, 32)
+        write = ReadHeader(buffer, UInt64, 24)
+        if read == write
+            if ReadHeader(buffer, UInt32, 40) == 1 && ReadHeader(buffer, UInt64, 24) == read
+                return nothing
+            end
+            sleep(1e-4)
+            continue
+        end
+
+        start = read % stream.capacity
+        record = streamHeaderSize + start
+        nHits = unsafe_load(Ptr{UInt32}(pointer(buffer, record + 1)))
+        if nHits == paddingRecord
+            WriteReadOffset(stream, read + stream.capacity - start)
+            continue
+        elseif nHits == endOfRunRecord
+            WriteReadOffset(stream, read + 8)
+            endOfRun && return DataFrame(ID = Int64[], X = Float64[], Y = Float64[],
+                                         Z = Float64[], E = Float64[],
+                                         Detector = Int64[])
+            continue
+        end
+
+        id = unsafe_load(Ptr{Int32}(pointer(buffer, record + 5)))
+        hits = Ptr{Float32}(pointer(buffer, record + 9))
+        X = [Float64(unsafe_load(hits, 8 * i + 1)) for i in 0:nHits-1]
+        Y = [Float64(unsafe_load(hits, 8 * i + 2)) for i in 0:nHits-1]
+        Z = [Float64(unsafe_load(hits, 8 * i + 3)) for i in 0:nHits-1]
+        E = [Float64(unsafe_load(hits, 8 * i + 4)) for i in 0:nHits-1]
+        detectors = Ptr{Int32}(pointer(buffer, record + 9))
+        D = [Int64(unsafe_load(detectors, 8 * i + 7)) for i in 0:nHits-1]
+        df = DataFrame(ID = fill(Int64(id), nHits), X = X, Y = Y, Z = Z, E = E,
+                       Detector = D)
+
+        # hand the space back to the producer only after copying the record
+        WriteReadOffset(stream, read + 8 + 32 * UInt64(nHits))
+        return df
+    end
+end
+
+function CloseHitStream(name::String)
+    rm(joinpath("/dev/shm", lstrip(name, '/')), force = true)
+end
+
+# Drift and simulate events as Geant4 produces them, see DriftGeant4Events
+function DriftGeant4Stream(name::String, sim, offset; time_step = 0.1u"ns",
+                           stepLimiter::Real = Inf)
+    stream = OpenHitStream(name)
+    events = Vector{Event}()
+    @info "Simulating events from hits stream $name"
+    while length(events) < stepLimiter
+        df = NextEvent(stream)
+        isnothing(df) && break
+        event = CreateSSDEvent(view(df, :, :), offset)
+        DriftEvent(event, sim, time_step)
+        SimulateWaveform(event, sim, time_step)
+        push!(events, event)
+    end
+    CloseHitStream(name)
+    return events
+end